@@ -0,0 +1,434 @@
+// Generated by tools/gen_geometry.py - do not edit.
+
+#pragma once
+
+#include <pebble.h>
+#include <pebble-fctx/fctx.h>
+
+#if defined(PBL_PLATFORM_EMERY)
+
+#define GEOMETRY_SCREEN_SIZE GSize(200, 228)
+#define GEOMETRY_DIAL_CENTER FPoint(1600, 1824)
+
+#define LAYOUT_BATTERY GRect(1, 98, 10, 17)
+#define LAYOUT_CONNECTION GRect(2, 118, 7, 13)
+#define LAYOUT_HEALTH_BPM_GRAPH GRect(1, 1, 34, 22)
+#define LAYOUT_HEALTH_BPM_TEXT GRect(1, 24, 50, 14)
+#define LAYOUT_HEALTH_METERS GRect(1, 185, 50, 14)
+#define LAYOUT_HEALTH_SLEEP GRect(1, 199, 77, 14)
+#define LAYOUT_HEALTH_CALS GRect(1, 213, 100, 14)
+#define LAYOUT_WEATHER_TEMP GRect(168, 114, 40, 30)
+#define LAYOUT_WEATHER_ICON GRect(171, 158, 25, 25)
+#define LAYOUT_WEATHER_PRECIPPROB GRect(180, 198, 20, 30)
+#define LAYOUT_WEATHER_PRECIPGRAPH GRect(104, 201, 49, 27)
+#define LAYOUT_MY_MESSAGE GRect(37, 0, 163, 14)
+#define LAYOUT_TIME GRect(66, 134, 66, 18)
+#define LAYOUT_DATE GRect(66, 152, 66, 15)
+
+// Pip outlines in fixed point screen coordinates, triangles repeat their last vertex.
+static const FPoint PIP_POLYGONS[60][4] = {
+    {FPoint(1600, 640), FPoint(1648, 448), FPoint(1552, 448), FPoint(1552, 448)},
+    {FPoint(1711, 615), FPoint(1717, 567), FPoint(1732, 569), FPoint(1727, 616)},
+    {FPoint(1822, 635), FPoint(1832, 588), FPoint(1847, 591), FPoint(1837, 638)},
+    {FPoint(1930, 668), FPoint(1944, 622), FPoint(1960, 627), FPoint(1945, 672)},
+    {FPoint(2034, 713), FPoint(2053, 669), FPoint(2068, 676), FPoint(2048, 720)},
+    {FPoint(2133, 771), FPoint(2209, 704), FPoint(2154, 672), FPoint(2154, 672)},
+    {FPoint(2227, 840), FPoint(2255, 801), FPoint(2268, 811), FPoint(2240, 850)},
+    {FPoint(2314, 920), FPoint(2346, 885), FPoint(2358, 895), FPoint(2326, 931)},
+    {FPoint(2393, 1010), FPoint(2428, 978), FPoint(2439, 990), FPoint(2403, 1022)},
+    {FPoint(2463, 1109), FPoint(2502, 1081), FPoint(2511, 1094), FPoint(2472, 1122)},
+    {FPoint(2524, 1216), FPoint(2623, 1196), FPoint(2591, 1140), FPoint(2591, 1140)},
+    {FPoint(2574, 1329), FPoint(2618, 1310), FPoint(2625, 1325), FPoint(2581, 1344)},
+    {FPoint(2614, 1448), FPoint(2660, 1433), FPoint(2665, 1449), FPoint(2619, 1463)},
+    {FPoint(2643, 1571), FPoint(2690, 1561), FPoint(2694, 1577), FPoint(2647, 1587)},
+    {FPoint(2661, 1697), FPoint(2709, 1692), FPoint(2710, 1708), FPoint(2662, 1713)},
+    {FPoint(2635, 1824), FPoint(2827, 1872), FPoint(2827, 1776), FPoint(2827, 1776)},
+    {FPoint(2661, 1951), FPoint(2709, 1956), FPoint(2707, 1972), FPoint(2659, 1967)},
+    {FPoint(2643, 2077), FPoint(2690, 2087), FPoint(2687, 2102), FPoint(2640, 2092)},
+    {FPoint(2614, 2200), FPoint(2660, 2215), FPoint(2655, 2230), FPoint(2610, 2215)},
+    {FPoint(2574, 2319), FPoint(2618, 2338), FPoint(2612, 2353), FPoint(2568, 2333)},
+    {FPoint(2524, 2432), FPoint(2591, 2508), FPoint(2623, 2452), FPoint(2623, 2452)},
+    {FPoint(2463, 2539), FPoint(2502, 2567), FPoint(2492, 2580), FPoint(2454, 2552)},
+    {FPoint(2393, 2638), FPoint(2428, 2670), FPoint(2418, 2682), FPoint(2382, 2650)},
+    {FPoint(2314, 2728), FPoint(2346, 2763), FPoint(2334, 2774), FPoint(2302, 2738)},
+    {FPoint(2227, 2808), FPoint(2255, 2847), FPoint(2242, 2856), FPoint(2214, 2817)},
+    {FPoint(2133, 2877), FPoint(2154, 2976), FPoint(2209, 2944), FPoint(2209, 2944)},
+    {FPoint(2034, 2935), FPoint(2053, 2979), FPoint(2039, 2985), FPoint(2019, 2941)},
+    {FPoint(1930, 2980), FPoint(1944, 3026), FPoint(1929, 3031), FPoint(1914, 2985)},
+    {FPoint(1822, 3013), FPoint(1832, 3060), FPoint(1816, 3064), FPoint(1806, 3017)},
+    {FPoint(1711, 3033), FPoint(1717, 3081), FPoint(1701, 3083), FPoint(1696, 3035)},
+    {FPoint(1600, 3008), FPoint(1552, 3200), FPoint(1648, 3200), FPoint(1648, 3200)},
+    {FPoint(1489, 3033), FPoint(1483, 3081), FPoint(1468, 3079), FPoint(1473, 3032)},
+    {FPoint(1378, 3013), FPoint(1368, 3060), FPoint(1353, 3057), FPoint(1363, 3010)},
+    {FPoint(1270, 2980), FPoint(1256, 3026), FPoint(1240, 3021), FPoint(1255, 2976)},
+    {FPoint(1166, 2935), FPoint(1147, 2979), FPoint(1132, 2972), FPoint(1152, 2928)},
+    {FPoint(1067, 2877), FPoint(991, 2944), FPoint(1046, 2976), FPoint(1046, 2976)},
+    {FPoint(973, 2808), FPoint(945, 2847), FPoint(932, 2837), FPoint(960, 2798)},
+    {FPoint(886, 2728), FPoint(854, 2763), FPoint(842, 2753), FPoint(874, 2717)},
+    {FPoint(807, 2638), FPoint(772, 2670), FPoint(761, 2658), FPoint(797, 2626)},
+    {FPoint(737, 2539), FPoint(698, 2567), FPoint(689, 2554), FPoint(728, 2526)},
+    {FPoint(676, 2432), FPoint(577, 2452), FPoint(609, 2508), FPoint(609, 2508)},
+    {FPoint(626, 2319), FPoint(582, 2338), FPoint(575, 2323), FPoint(619, 2304)},
+    {FPoint(586, 2200), FPoint(540, 2215), FPoint(535, 2199), FPoint(581, 2185)},
+    {FPoint(557, 2077), FPoint(510, 2087), FPoint(506, 2071), FPoint(553, 2061)},
+    {FPoint(539, 1951), FPoint(491, 1956), FPoint(490, 1940), FPoint(538, 1935)},
+    {FPoint(565, 1824), FPoint(373, 1776), FPoint(373, 1872), FPoint(373, 1872)},
+    {FPoint(539, 1697), FPoint(491, 1692), FPoint(493, 1676), FPoint(541, 1681)},
+    {FPoint(557, 1571), FPoint(510, 1561), FPoint(513, 1546), FPoint(560, 1556)},
+    {FPoint(586, 1448), FPoint(540, 1433), FPoint(545, 1418), FPoint(590, 1433)},
+    {FPoint(626, 1329), FPoint(582, 1310), FPoint(588, 1295), FPoint(632, 1315)},
+    {FPoint(676, 1216), FPoint(609, 1140), FPoint(577, 1196), FPoint(577, 1196)},
+    {FPoint(737, 1109), FPoint(698, 1081), FPoint(708, 1068), FPoint(746, 1096)},
+    {FPoint(807, 1010), FPoint(772, 978), FPoint(782, 966), FPoint(818, 998)},
+    {FPoint(886, 920), FPoint(854, 885), FPoint(866, 874), FPoint(898, 910)},
+    {FPoint(973, 840), FPoint(945, 801), FPoint(958, 792), FPoint(986, 831)},
+    {FPoint(1067, 771), FPoint(1046, 672), FPoint(991, 704), FPoint(991, 704)},
+    {FPoint(1166, 713), FPoint(1147, 669), FPoint(1161, 663), FPoint(1181, 707)},
+    {FPoint(1270, 668), FPoint(1256, 622), FPoint(1271, 617), FPoint(1286, 663)},
+    {FPoint(1378, 635), FPoint(1368, 588), FPoint(1384, 584), FPoint(1394, 631)},
+    {FPoint(1489, 615), FPoint(1483, 567), FPoint(1499, 565), FPoint(1504, 613)},
+};
+
+// Minute hand tip and the two base corners, per minute.
+static const FPoint MINUTE_HAND[60][3] = {
+    {FPoint(1600, 608), FPoint(1689, 857), FPoint(1511, 857)},
+    {FPoint(1711, 615), FPoint(1777, 872), FPoint(1600, 851)},
+    {FPoint(1822, 635), FPoint(1864, 899), FPoint(1689, 857)},
+    {FPoint(1930, 668), FPoint(1947, 935), FPoint(1777, 872)},
+    {FPoint(2034, 713), FPoint(2027, 982), FPoint(1864, 899)},
+    {FPoint(2133, 771), FPoint(2102, 1037), FPoint(1947, 935)},
+    {FPoint(2227, 840), FPoint(2171, 1101), FPoint(2027, 982)},
+    {FPoint(2314, 920), FPoint(2234, 1173), FPoint(2102, 1037)},
+    {FPoint(2393, 1010), FPoint(2290, 1252), FPoint(2171, 1101)},
+    {FPoint(2463, 1109), FPoint(2339, 1338), FPoint(2234, 1173)},
+    {FPoint(2524, 1216), FPoint(2380, 1428), FPoint(2290, 1252)},
+    {FPoint(2574, 1329), FPoint(2412, 1523), FPoint(2339, 1338)},
+    {FPoint(2614, 1448), FPoint(2435, 1622), FPoint(2380, 1428)},
+    {FPoint(2643, 1571), FPoint(2449, 1722), FPoint(2412, 1523)},
+    {FPoint(2661, 1697), FPoint(2453, 1824), FPoint(2435, 1622)},
+    {FPoint(2667, 1824), FPoint(2449, 1926), FPoint(2449, 1722)},
+    {FPoint(2661, 1951), FPoint(2435, 2026), FPoint(2453, 1824)},
+    {FPoint(2643, 2077), FPoint(2412, 2125), FPoint(2449, 1926)},
+    {FPoint(2614, 2200), FPoint(2380, 2220), FPoint(2435, 2026)},
+    {FPoint(2574, 2319), FPoint(2339, 2310), FPoint(2412, 2125)},
+    {FPoint(2524, 2432), FPoint(2290, 2396), FPoint(2380, 2220)},
+    {FPoint(2463, 2539), FPoint(2234, 2475), FPoint(2339, 2310)},
+    {FPoint(2393, 2638), FPoint(2171, 2547), FPoint(2290, 2396)},
+    {FPoint(2314, 2728), FPoint(2102, 2611), FPoint(2234, 2475)},
+    {FPoint(2227, 2808), FPoint(2027, 2666), FPoint(2171, 2547)},
+    {FPoint(2133, 2877), FPoint(1947, 2713), FPoint(2102, 2611)},
+    {FPoint(2034, 2935), FPoint(1864, 2749), FPoint(2027, 2666)},
+    {FPoint(1930, 2980), FPoint(1777, 2776), FPoint(1947, 2713)},
+    {FPoint(1822, 3013), FPoint(1689, 2791), FPoint(1864, 2749)},
+    {FPoint(1711, 3033), FPoint(1600, 2797), FPoint(1777, 2776)},
+    {FPoint(1600, 3040), FPoint(1511, 2791), FPoint(1689, 2791)},
+    {FPoint(1489, 3033), FPoint(1423, 2776), FPoint(1600, 2797)},
+    {FPoint(1378, 3013), FPoint(1336, 2749), FPoint(1511, 2791)},
+    {FPoint(1270, 2980), FPoint(1253, 2713), FPoint(1423, 2776)},
+    {FPoint(1166, 2935), FPoint(1173, 2666), FPoint(1336, 2749)},
+    {FPoint(1067, 2877), FPoint(1098, 2611), FPoint(1253, 2713)},
+    {FPoint(973, 2808), FPoint(1029, 2547), FPoint(1173, 2666)},
+    {FPoint(886, 2728), FPoint(966, 2475), FPoint(1098, 2611)},
+    {FPoint(807, 2638), FPoint(910, 2396), FPoint(1029, 2547)},
+    {FPoint(737, 2539), FPoint(861, 2310), FPoint(966, 2475)},
+    {FPoint(676, 2432), FPoint(820, 2220), FPoint(910, 2396)},
+    {FPoint(626, 2319), FPoint(788, 2125), FPoint(861, 2310)},
+    {FPoint(586, 2200), FPoint(765, 2026), FPoint(820, 2220)},
+    {FPoint(557, 2077), FPoint(751, 1926), FPoint(788, 2125)},
+    {FPoint(539, 1951), FPoint(747, 1824), FPoint(765, 2026)},
+    {FPoint(533, 1824), FPoint(751, 1722), FPoint(751, 1926)},
+    {FPoint(539, 1697), FPoint(765, 1622), FPoint(747, 1824)},
+    {FPoint(557, 1571), FPoint(788, 1523), FPoint(751, 1722)},
+    {FPoint(586, 1448), FPoint(820, 1428), FPoint(765, 1622)},
+    {FPoint(626, 1329), FPoint(861, 1338), FPoint(788, 1523)},
+    {FPoint(676, 1216), FPoint(910, 1252), FPoint(820, 1428)},
+    {FPoint(737, 1109), FPoint(966, 1173), FPoint(861, 1338)},
+    {FPoint(807, 1010), FPoint(1029, 1101), FPoint(910, 1252)},
+    {FPoint(886, 920), FPoint(1098, 1037), FPoint(966, 1173)},
+    {FPoint(973, 840), FPoint(1173, 982), FPoint(1029, 1101)},
+    {FPoint(1067, 771), FPoint(1253, 935), FPoint(1098, 1037)},
+    {FPoint(1166, 713), FPoint(1336, 899), FPoint(1173, 982)},
+    {FPoint(1270, 668), FPoint(1423, 872), FPoint(1253, 935)},
+    {FPoint(1378, 635), FPoint(1511, 857), FPoint(1336, 899)},
+    {FPoint(1489, 615), FPoint(1600, 851), FPoint(1423, 872)},
+};
+
+// Seconds hand outline, per second.
+static const FPoint SECOND_HAND[60][4] = {
+    {FPoint(1616, 1824), FPoint(1616, 883), FPoint(1584, 883), FPoint(1584, 1824)},
+    {FPoint(1616, 1826), FPoint(1702, 890), FPoint(1670, 887), FPoint(1584, 1822)},
+    {FPoint(1616, 1827), FPoint(1786, 907), FPoint(1755, 900), FPoint(1584, 1821)},
+    {FPoint(1615, 1829), FPoint(1869, 934), FPoint(1839, 924), FPoint(1585, 1819)},
+    {FPoint(1615, 1831), FPoint(1949, 971), FPoint(1919, 958), FPoint(1585, 1817)},
+    {FPoint(1614, 1832), FPoint(2025, 1017), FPoint(1997, 1001), FPoint(1586, 1816)},
+    {FPoint(1613, 1833), FPoint(2096, 1072), FPoint(2070, 1053), FPoint(1587, 1815)},
+    {FPoint(1612, 1835), FPoint(2161, 1136), FPoint(2138, 1114), FPoint(1588, 1813)},
+    {FPoint(1611, 1836), FPoint(2221, 1206), FPoint(2200, 1183), FPoint(1589, 1812)},
+    {FPoint(1609, 1837), FPoint(2274, 1284), FPoint(2255, 1258), FPoint(1591, 1811)},
+    {FPoint(1608, 1838), FPoint(2319, 1367), FPoint(2303, 1340), FPoint(1592, 1810)},
+    {FPoint(1607, 1839), FPoint(2357, 1456), FPoint(2344, 1427), FPoint(1593, 1809)},
+    {FPoint(1605, 1839), FPoint(2386, 1548), FPoint(2376, 1518), FPoint(1595, 1809)},
+    {FPoint(1603, 1840), FPoint(2407, 1644), FPoint(2400, 1613), FPoint(1597, 1808)},
+    {FPoint(1602, 1840), FPoint(2419, 1742), FPoint(2415, 1710), FPoint(1598, 1808)},
+    {FPoint(1600, 1840), FPoint(2421, 1840), FPoint(2421, 1808), FPoint(1600, 1808)},
+    {FPoint(1598, 1840), FPoint(2415, 1938), FPoint(2419, 1906), FPoint(1602, 1808)},
+    {FPoint(1597, 1840), FPoint(2400, 2035), FPoint(2407, 2004), FPoint(1603, 1808)},
+    {FPoint(1595, 1839), FPoint(2376, 2130), FPoint(2386, 2100), FPoint(1605, 1809)},
+    {FPoint(1593, 1839), FPoint(2344, 2221), FPoint(2357, 2192), FPoint(1607, 1809)},
+    {FPoint(1592, 1838), FPoint(2303, 2308), FPoint(2319, 2281), FPoint(1608, 1810)},
+    {FPoint(1591, 1837), FPoint(2255, 2390), FPoint(2274, 2364), FPoint(1609, 1811)},
+    {FPoint(1589, 1836), FPoint(2200, 2465), FPoint(2221, 2442), FPoint(1611, 1812)},
+    {FPoint(1588, 1835), FPoint(2138, 2534), FPoint(2161, 2512), FPoint(1612, 1813)},
+    {FPoint(1587, 1833), FPoint(2070, 2595), FPoint(2096, 2576), FPoint(1613, 1815)},
+    {FPoint(1586, 1832), FPoint(1997, 2647), FPoint(2025, 2631), FPoint(1614, 1816)},
+    {FPoint(1585, 1831), FPoint(1919, 2690), FPoint(1949, 2677), FPoint(1615, 1817)},
+    {FPoint(1585, 1829), FPoint(1839, 2724), FPoint(1869, 2714), FPoint(1615, 1819)},
+    {FPoint(1584, 1827), FPoint(1755, 2748), FPoint(1786, 2741), FPoint(1616, 1821)},
+    {FPoint(1584, 1826), FPoint(1670, 2761), FPoint(1702, 2758), FPoint(1616, 1822)},
+    {FPoint(1584, 1824), FPoint(1584, 2765), FPoint(1616, 2765), FPoint(1616, 1824)},
+    {FPoint(1584, 1822), FPoint(1498, 2758), FPoint(1530, 2761), FPoint(1616, 1826)},
+    {FPoint(1584, 1821), FPoint(1414, 2741), FPoint(1445, 2748), FPoint(1616, 1827)},
+    {FPoint(1585, 1819), FPoint(1331, 2714), FPoint(1361, 2724), FPoint(1615, 1829)},
+    {FPoint(1585, 1817), FPoint(1251, 2677), FPoint(1281, 2690), FPoint(1615, 1831)},
+    {FPoint(1586, 1816), FPoint(1175, 2631), FPoint(1203, 2647), FPoint(1614, 1832)},
+    {FPoint(1587, 1815), FPoint(1104, 2576), FPoint(1130, 2595), FPoint(1613, 1833)},
+    {FPoint(1588, 1813), FPoint(1039, 2512), FPoint(1062, 2534), FPoint(1612, 1835)},
+    {FPoint(1589, 1812), FPoint(979, 2442), FPoint(1000, 2465), FPoint(1611, 1836)},
+    {FPoint(1591, 1811), FPoint(926, 2364), FPoint(945, 2390), FPoint(1609, 1837)},
+    {FPoint(1592, 1810), FPoint(881, 2281), FPoint(897, 2308), FPoint(1608, 1838)},
+    {FPoint(1593, 1809), FPoint(843, 2192), FPoint(856, 2221), FPoint(1607, 1839)},
+    {FPoint(1595, 1809), FPoint(814, 2100), FPoint(824, 2130), FPoint(1605, 1839)},
+    {FPoint(1597, 1808), FPoint(793, 2004), FPoint(800, 2035), FPoint(1603, 1840)},
+    {FPoint(1598, 1808), FPoint(781, 1906), FPoint(785, 1938), FPoint(1602, 1840)},
+    {FPoint(1600, 1808), FPoint(779, 1808), FPoint(779, 1840), FPoint(1600, 1840)},
+    {FPoint(1602, 1808), FPoint(785, 1710), FPoint(781, 1742), FPoint(1598, 1840)},
+    {FPoint(1603, 1808), FPoint(800, 1613), FPoint(793, 1644), FPoint(1597, 1840)},
+    {FPoint(1605, 1809), FPoint(824, 1518), FPoint(814, 1548), FPoint(1595, 1839)},
+    {FPoint(1607, 1809), FPoint(856, 1427), FPoint(843, 1456), FPoint(1593, 1839)},
+    {FPoint(1608, 1810), FPoint(897, 1340), FPoint(881, 1367), FPoint(1592, 1838)},
+    {FPoint(1609, 1811), FPoint(945, 1258), FPoint(926, 1284), FPoint(1591, 1837)},
+    {FPoint(1611, 1812), FPoint(1000, 1183), FPoint(979, 1206), FPoint(1589, 1836)},
+    {FPoint(1612, 1813), FPoint(1062, 1114), FPoint(1039, 1136), FPoint(1588, 1835)},
+    {FPoint(1613, 1815), FPoint(1130, 1053), FPoint(1104, 1072), FPoint(1587, 1833)},
+    {FPoint(1614, 1816), FPoint(1203, 1001), FPoint(1175, 1017), FPoint(1586, 1832)},
+    {FPoint(1615, 1817), FPoint(1281, 958), FPoint(1251, 971), FPoint(1585, 1831)},
+    {FPoint(1615, 1819), FPoint(1361, 924), FPoint(1331, 934), FPoint(1585, 1829)},
+    {FPoint(1616, 1821), FPoint(1445, 900), FPoint(1414, 907), FPoint(1584, 1827)},
+    {FPoint(1616, 1822), FPoint(1530, 887), FPoint(1498, 890), FPoint(1584, 1826)},
+};
+
+#elif defined(PBL_PLATFORM_BASALT) || defined(PBL_PLATFORM_DIORITE)
+
+#define GEOMETRY_SCREEN_SIZE GSize(144, 168)
+#define GEOMETRY_DIAL_CENTER FPoint(1152, 1344)
+
+#define LAYOUT_BATTERY GRect(1, 68, 10, 17)
+#define LAYOUT_CONNECTION GRect(2, 88, 7, 13)
+#define LAYOUT_HEALTH_BPM_GRAPH GRect(1, 1, 34, 22)
+#define LAYOUT_HEALTH_BPM_TEXT GRect(1, 24, 36, 14)
+#define LAYOUT_HEALTH_METERS GRect(1, 125, 36, 14)
+#define LAYOUT_HEALTH_SLEEP GRect(1, 139, 54, 14)
+#define LAYOUT_HEALTH_CALS GRect(1, 153, 72, 14)
+#define LAYOUT_WEATHER_TEMP GRect(112, 84, 40, 30)
+#define LAYOUT_WEATHER_ICON GRect(115, 116, 25, 25)
+#define LAYOUT_WEATHER_PRECIPPROB GRect(124, 138, 20, 30)
+#define LAYOUT_WEATHER_PRECIPGRAPH GRect(76, 141, 49, 27)
+#define LAYOUT_MY_MESSAGE GRect(37, 0, 107, 14)
+#define LAYOUT_TIME GRect(48, 94, 48, 18)
+#define LAYOUT_DATE GRect(48, 112, 48, 15)
+
+// Pip outlines in fixed point screen coordinates, triangles repeat their last vertex.
+static const FPoint PIP_POLYGONS[60][4] = {
+    {FPoint(1152, 480), FPoint(1200, 288), FPoint(1104, 288), FPoint(1104, 288)},
+    {FPoint(1232, 453), FPoint(1237, 405), FPoint(1253, 407), FPoint(1248, 455)},
+    {FPoint(1312, 468), FPoint(1322, 421), FPoint(1337, 424), FPoint(1327, 471)},
+    {FPoint(1389, 492), FPoint(1404, 446), FPoint(1419, 451), FPoint(1405, 497)},
+    {FPoint(1464, 525), FPoint(1484, 482), FPoint(1499, 488), FPoint(1479, 532)},
+    {FPoint(1536, 568), FPoint(1612, 501), FPoint(1556, 469), FPoint(1556, 469)},
+    {FPoint(1603, 619), FPoint(1632, 580), FPoint(1645, 590), FPoint(1616, 629)},
+    {FPoint(1666, 678), FPoint(1698, 642), FPoint(1710, 653), FPoint(1678, 689)},
+    {FPoint(1723, 744), FPoint(1758, 712), FPoint(1769, 724), FPoint(1733, 756)},
+    {FPoint(1773, 817), FPoint(1812, 789), FPoint(1822, 802), FPoint(1783, 830)},
+    {FPoint(1817, 896), FPoint(1916, 876), FPoint(1884, 820), FPoint(1884, 820)},
+    {FPoint(1854, 980), FPoint(1897, 960), FPoint(1904, 975), FPoint(1860, 994)},
+    {FPoint(1882, 1067), FPoint(1928, 1052), FPoint(1933, 1068), FPoint(1887, 1082)},
+    {FPoint(1903, 1158), FPoint(1950, 1148), FPoint(1953, 1163), FPoint(1907, 1173)},
+    {FPoint(1916, 1250), FPoint(1964, 1245), FPoint(1965, 1261), FPoint(1917, 1266)},
+    {FPoint(1888, 1344), FPoint(2080, 1392), FPoint(2080, 1296), FPoint(2080, 1296)},
+    {FPoint(1916, 1438), FPoint(1964, 1443), FPoint(1962, 1459), FPoint(1914, 1454)},
+    {FPoint(1903, 1530), FPoint(1950, 1540), FPoint(1947, 1556), FPoint(1900, 1546)},
+    {FPoint(1882, 1621), FPoint(1928, 1636), FPoint(1923, 1651), FPoint(1877, 1636)},
+    {FPoint(1854, 1708), FPoint(1897, 1728), FPoint(1891, 1743), FPoint(1847, 1723)},
+    {FPoint(1817, 1792), FPoint(1884, 1868), FPoint(1916, 1812), FPoint(1916, 1812)},
+    {FPoint(1773, 1871), FPoint(1812, 1899), FPoint(1803, 1912), FPoint(1764, 1884)},
+    {FPoint(1723, 1944), FPoint(1758, 1976), FPoint(1748, 1988), FPoint(1712, 1955)},
+    {FPoint(1666, 2010), FPoint(1698, 2046), FPoint(1686, 2056), FPoint(1654, 2021)},
+    {FPoint(1603, 2069), FPoint(1632, 2108), FPoint(1619, 2117), FPoint(1590, 2078)},
+    {FPoint(1536, 2120), FPoint(1556, 2219), FPoint(1612, 2187), FPoint(1612, 2187)},
+    {FPoint(1464, 2163), FPoint(1484, 2206), FPoint(1469, 2213), FPoint(1450, 2169)},
+    {FPoint(1389, 2196), FPoint(1404, 2242), FPoint(1389, 2247), FPoint(1374, 2201)},
+    {FPoint(1312, 2220), FPoint(1322, 2267), FPoint(1306, 2271), FPoint(1296, 2224)},
+    {FPoint(1232, 2235), FPoint(1237, 2283), FPoint(1221, 2285), FPoint(1216, 2237)},
+    {FPoint(1152, 2208), FPoint(1104, 2400), FPoint(1200, 2400), FPoint(1200, 2400)},
+    {FPoint(1072, 2235), FPoint(1067, 2283), FPoint(1051, 2281), FPoint(1056, 2233)},
+    {FPoint(992, 2220), FPoint(982, 2267), FPoint(967, 2264), FPoint(977, 2217)},
+    {FPoint(915, 2196), FPoint(900, 2242), FPoint(885, 2237), FPoint(899, 2191)},
+    {FPoint(840, 2163), FPoint(820, 2206), FPoint(805, 2200), FPoint(825, 2156)},
+    {FPoint(768, 2120), FPoint(692, 2187), FPoint(748, 2219), FPoint(748, 2219)},
+    {FPoint(701, 2069), FPoint(672, 2108), FPoint(659, 2098), FPoint(688, 2059)},
+    {FPoint(638, 2010), FPoint(606, 2046), FPoint(594, 2035), FPoint(626, 1999)},
+    {FPoint(581, 1944), FPoint(546, 1976), FPoint(535, 1964), FPoint(571, 1932)},
+    {FPoint(531, 1871), FPoint(492, 1899), FPoint(482, 1886), FPoint(521, 1858)},
+    {FPoint(487, 1792), FPoint(388, 1812), FPoint(420, 1868), FPoint(420, 1868)},
+    {FPoint(450, 1708), FPoint(407, 1728), FPoint(400, 1713), FPoint(444, 1694)},
+    {FPoint(422, 1621), FPoint(376, 1636), FPoint(371, 1620), FPoint(417, 1606)},
+    {FPoint(401, 1530), FPoint(354, 1540), FPoint(351, 1525), FPoint(397, 1515)},
+    {FPoint(388, 1438), FPoint(340, 1443), FPoint(339, 1427), FPoint(387, 1422)},
+    {FPoint(416, 1344), FPoint(224, 1296), FPoint(224, 1392), FPoint(224, 1392)},
+    {FPoint(388, 1250), FPoint(340, 1245), FPoint(342, 1229), FPoint(390, 1234)},
+    {FPoint(401, 1158), FPoint(354, 1148), FPoint(357, 1132), FPoint(404, 1142)},
+    {FPoint(422, 1067), FPoint(376, 1052), FPoint(381, 1037), FPoint(427, 1052)},
+    {FPoint(450, 980), FPoint(407, 960), FPoint(413, 945), FPoint(457, 965)},
+    {FPoint(487, 896), FPoint(420, 820), FPoint(388, 876), FPoint(388, 876)},
+    {FPoint(531, 817), FPoint(492, 789), FPoint(501, 776), FPoint(540, 804)},
+    {FPoint(581, 744), FPoint(546, 712), FPoint(556, 700), FPoint(592, 733)},
+    {FPoint(638, 678), FPoint(606, 642), FPoint(618, 632), FPoint(650, 667)},
+    {FPoint(701, 619), FPoint(672, 580), FPoint(685, 571), FPoint(714, 610)},
+    {FPoint(768, 568), FPoint(748, 469), FPoint(692, 501), FPoint(692, 501)},
+    {FPoint(840, 525), FPoint(820, 482), FPoint(835, 475), FPoint(854, 519)},
+    {FPoint(915, 492), FPoint(900, 446), FPoint(915, 441), FPoint(930, 487)},
+    {FPoint(992, 468), FPoint(982, 421), FPoint(998, 417), FPoint(1008, 464)},
+    {FPoint(1072, 453), FPoint(1067, 405), FPoint(1083, 403), FPoint(1088, 451)},
+};
+
+// Minute hand tip and the two base corners, per minute.
+static const FPoint MINUTE_HAND[60][3] = {
+    {FPoint(1152, 448), FPoint(1216, 631), FPoint(1088, 631)},
+    {FPoint(1232, 453), FPoint(1280, 643), FPoint(1152, 627)},
+    {FPoint(1312, 468), FPoint(1342, 662), FPoint(1216, 631)},
+    {FPoint(1389, 492), FPoint(1402, 689), FPoint(1280, 643)},
+    {FPoint(1464, 525), FPoint(1459, 723), FPoint(1342, 662)},
+    {FPoint(1536, 568), FPoint(1513, 764), FPoint(1402, 689)},
+    {FPoint(1603, 619), FPoint(1563, 811), FPoint(1459, 723)},
+    {FPoint(1666, 678), FPoint(1609, 864), FPoint(1513, 764)},
+    {FPoint(1723, 744), FPoint(1649, 923), FPoint(1563, 811)},
+    {FPoint(1773, 817), FPoint(1684, 986), FPoint(1609, 864)},
+    {FPoint(1817, 896), FPoint(1713, 1052), FPoint(1649, 923)},
+    {FPoint(1854, 980), FPoint(1736, 1122), FPoint(1684, 986)},
+    {FPoint(1882, 1067), FPoint(1753, 1195), FPoint(1713, 1052)},
+    {FPoint(1903, 1158), FPoint(1763, 1269), FPoint(1736, 1122)},
+    {FPoint(1916, 1250), FPoint(1766, 1344), FPoint(1753, 1195)},
+    {FPoint(1920, 1344), FPoint(1763, 1419), FPoint(1763, 1269)},
+    {FPoint(1916, 1438), FPoint(1753, 1493), FPoint(1766, 1344)},
+    {FPoint(1903, 1530), FPoint(1736, 1566), FPoint(1763, 1419)},
+    {FPoint(1882, 1621), FPoint(1713, 1636), FPoint(1753, 1493)},
+    {FPoint(1854, 1708), FPoint(1684, 1702), FPoint(1736, 1566)},
+    {FPoint(1817, 1792), FPoint(1649, 1765), FPoint(1713, 1636)},
+    {FPoint(1773, 1871), FPoint(1609, 1824), FPoint(1684, 1702)},
+    {FPoint(1723, 1944), FPoint(1563, 1877), FPoint(1649, 1765)},
+    {FPoint(1666, 2010), FPoint(1513, 1924), FPoint(1609, 1824)},
+    {FPoint(1603, 2069), FPoint(1459, 1965), FPoint(1563, 1877)},
+    {FPoint(1536, 2120), FPoint(1402, 1999), FPoint(1513, 1924)},
+    {FPoint(1464, 2163), FPoint(1342, 2026), FPoint(1459, 1965)},
+    {FPoint(1389, 2196), FPoint(1280, 2045), FPoint(1402, 1999)},
+    {FPoint(1312, 2220), FPoint(1216, 2057), FPoint(1342, 2026)},
+    {FPoint(1232, 2235), FPoint(1152, 2061), FPoint(1280, 2045)},
+    {FPoint(1152, 2240), FPoint(1088, 2057), FPoint(1216, 2057)},
+    {FPoint(1072, 2235), FPoint(1024, 2045), FPoint(1152, 2061)},
+    {FPoint(992, 2220), FPoint(962, 2026), FPoint(1088, 2057)},
+    {FPoint(915, 2196), FPoint(902, 1999), FPoint(1024, 2045)},
+    {FPoint(840, 2163), FPoint(845, 1965), FPoint(962, 2026)},
+    {FPoint(768, 2120), FPoint(791, 1924), FPoint(902, 1999)},
+    {FPoint(701, 2069), FPoint(741, 1877), FPoint(845, 1965)},
+    {FPoint(638, 2010), FPoint(695, 1824), FPoint(791, 1924)},
+    {FPoint(581, 1944), FPoint(655, 1765), FPoint(741, 1877)},
+    {FPoint(531, 1871), FPoint(620, 1702), FPoint(695, 1824)},
+    {FPoint(487, 1792), FPoint(591, 1636), FPoint(655, 1765)},
+    {FPoint(450, 1708), FPoint(568, 1566), FPoint(620, 1702)},
+    {FPoint(422, 1621), FPoint(551, 1493), FPoint(591, 1636)},
+    {FPoint(401, 1530), FPoint(541, 1419), FPoint(568, 1566)},
+    {FPoint(388, 1438), FPoint(538, 1344), FPoint(551, 1493)},
+    {FPoint(384, 1344), FPoint(541, 1269), FPoint(541, 1419)},
+    {FPoint(388, 1250), FPoint(551, 1195), FPoint(538, 1344)},
+    {FPoint(401, 1158), FPoint(568, 1122), FPoint(541, 1269)},
+    {FPoint(422, 1067), FPoint(591, 1052), FPoint(551, 1195)},
+    {FPoint(450, 980), FPoint(620, 986), FPoint(568, 1122)},
+    {FPoint(487, 896), FPoint(655, 923), FPoint(591, 1052)},
+    {FPoint(531, 817), FPoint(695, 864), FPoint(620, 986)},
+    {FPoint(581, 744), FPoint(741, 811), FPoint(655, 923)},
+    {FPoint(638, 678), FPoint(791, 764), FPoint(695, 864)},
+    {FPoint(701, 619), FPoint(845, 723), FPoint(741, 811)},
+    {FPoint(768, 568), FPoint(902, 689), FPoint(791, 764)},
+    {FPoint(840, 525), FPoint(962, 662), FPoint(845, 723)},
+    {FPoint(915, 492), FPoint(1024, 643), FPoint(902, 689)},
+    {FPoint(992, 468), FPoint(1088, 631), FPoint(962, 662)},
+    {FPoint(1072, 453), FPoint(1152, 627), FPoint(1024, 643)},
+};
+
+// Seconds hand outline, per second.
+static const FPoint SECOND_HAND[60][4] = {
+    {FPoint(1168, 1344), FPoint(1168, 659), FPoint(1136, 659), FPoint(1136, 1344)},
+    {FPoint(1168, 1346), FPoint(1229, 665), FPoint(1197, 661), FPoint(1136, 1342)},
+    {FPoint(1168, 1347), FPoint(1289, 677), FPoint(1257, 671), FPoint(1136, 1341)},
+    {FPoint(1167, 1349), FPoint(1347, 698), FPoint(1317, 688), FPoint(1137, 1339)},
+    {FPoint(1167, 1351), FPoint(1404, 725), FPoint(1374, 712), FPoint(1137, 1337)},
+    {FPoint(1166, 1352), FPoint(1457, 759), FPoint(1429, 743), FPoint(1138, 1336)},
+    {FPoint(1165, 1353), FPoint(1507, 799), FPoint(1481, 781), FPoint(1139, 1335)},
+    {FPoint(1164, 1355), FPoint(1554, 846), FPoint(1530, 824), FPoint(1140, 1333)},
+    {FPoint(1163, 1356), FPoint(1596, 898), FPoint(1574, 874), FPoint(1141, 1332)},
+    {FPoint(1161, 1357), FPoint(1633, 954), FPoint(1614, 929), FPoint(1143, 1331)},
+    {FPoint(1160, 1358), FPoint(1664, 1015), FPoint(1648, 988), FPoint(1144, 1330)},
+    {FPoint(1159, 1359), FPoint(1691, 1080), FPoint(1678, 1051), FPoint(1145, 1329)},
+    {FPoint(1157, 1359), FPoint(1711, 1148), FPoint(1701, 1117), FPoint(1147, 1329)},
+    {FPoint(1155, 1360), FPoint(1725, 1217), FPoint(1718, 1186), FPoint(1149, 1328)},
+    {FPoint(1154, 1360), FPoint(1733, 1288), FPoint(1730, 1257), FPoint(1150, 1328)},
+    {FPoint(1152, 1360), FPoint(1734, 1360), FPoint(1734, 1328), FPoint(1152, 1328)},
+    {FPoint(1150, 1360), FPoint(1730, 1431), FPoint(1733, 1400), FPoint(1154, 1328)},
+    {FPoint(1149, 1360), FPoint(1718, 1502), FPoint(1725, 1471), FPoint(1155, 1328)},
+    {FPoint(1147, 1359), FPoint(1701, 1571), FPoint(1711, 1540), FPoint(1157, 1329)},
+    {FPoint(1145, 1359), FPoint(1678, 1637), FPoint(1691, 1608), FPoint(1159, 1329)},
+    {FPoint(1144, 1358), FPoint(1648, 1700), FPoint(1664, 1673), FPoint(1160, 1330)},
+    {FPoint(1143, 1357), FPoint(1614, 1759), FPoint(1633, 1734), FPoint(1161, 1331)},
+    {FPoint(1141, 1356), FPoint(1574, 1814), FPoint(1596, 1790), FPoint(1163, 1332)},
+    {FPoint(1140, 1355), FPoint(1530, 1864), FPoint(1554, 1842), FPoint(1164, 1333)},
+    {FPoint(1139, 1353), FPoint(1481, 1907), FPoint(1507, 1889), FPoint(1165, 1335)},
+    {FPoint(1138, 1352), FPoint(1429, 1945), FPoint(1457, 1929), FPoint(1166, 1336)},
+    {FPoint(1137, 1351), FPoint(1374, 1976), FPoint(1404, 1963), FPoint(1167, 1337)},
+    {FPoint(1137, 1349), FPoint(1317, 2000), FPoint(1347, 1990), FPoint(1167, 1339)},
+    {FPoint(1136, 1347), FPoint(1257, 2017), FPoint(1289, 2011), FPoint(1168, 1341)},
+    {FPoint(1136, 1346), FPoint(1197, 2027), FPoint(1229, 2023), FPoint(1168, 1342)},
+    {FPoint(1136, 1344), FPoint(1136, 2029), FPoint(1168, 2029), FPoint(1168, 1344)},
+    {FPoint(1136, 1342), FPoint(1075, 2023), FPoint(1107, 2027), FPoint(1168, 1346)},
+    {FPoint(1136, 1341), FPoint(1015, 2011), FPoint(1047, 2017), FPoint(1168, 1347)},
+    {FPoint(1137, 1339), FPoint(957, 1990), FPoint(987, 2000), FPoint(1167, 1349)},
+    {FPoint(1137, 1337), FPoint(900, 1963), FPoint(930, 1976), FPoint(1167, 1351)},
+    {FPoint(1138, 1336), FPoint(847, 1929), FPoint(875, 1945), FPoint(1166, 1352)},
+    {FPoint(1139, 1335), FPoint(797, 1889), FPoint(823, 1907), FPoint(1165, 1353)},
+    {FPoint(1140, 1333), FPoint(750, 1842), FPoint(774, 1864), FPoint(1164, 1355)},
+    {FPoint(1141, 1332), FPoint(708, 1790), FPoint(730, 1814), FPoint(1163, 1356)},
+    {FPoint(1143, 1331), FPoint(671, 1734), FPoint(690, 1759), FPoint(1161, 1357)},
+    {FPoint(1144, 1330), FPoint(640, 1673), FPoint(656, 1700), FPoint(1160, 1358)},
+    {FPoint(1145, 1329), FPoint(613, 1608), FPoint(626, 1637), FPoint(1159, 1359)},
+    {FPoint(1147, 1329), FPoint(593, 1540), FPoint(603, 1571), FPoint(1157, 1359)},
+    {FPoint(1149, 1328), FPoint(579, 1471), FPoint(586, 1502), FPoint(1155, 1360)},
+    {FPoint(1150, 1328), FPoint(571, 1400), FPoint(574, 1431), FPoint(1154, 1360)},
+    {FPoint(1152, 1328), FPoint(570, 1328), FPoint(570, 1360), FPoint(1152, 1360)},
+    {FPoint(1154, 1328), FPoint(574, 1257), FPoint(571, 1288), FPoint(1150, 1360)},
+    {FPoint(1155, 1328), FPoint(586, 1186), FPoint(579, 1217), FPoint(1149, 1360)},
+    {FPoint(1157, 1329), FPoint(603, 1117), FPoint(593, 1148), FPoint(1147, 1359)},
+    {FPoint(1159, 1329), FPoint(626, 1051), FPoint(613, 1080), FPoint(1145, 1359)},
+    {FPoint(1160, 1330), FPoint(656, 988), FPoint(640, 1015), FPoint(1144, 1358)},
+    {FPoint(1161, 1331), FPoint(690, 929), FPoint(671, 954), FPoint(1143, 1357)},
+    {FPoint(1163, 1332), FPoint(730, 874), FPoint(708, 898), FPoint(1141, 1356)},
+    {FPoint(1164, 1333), FPoint(774, 824), FPoint(750, 846), FPoint(1140, 1355)},
+    {FPoint(1165, 1335), FPoint(823, 781), FPoint(797, 799), FPoint(1139, 1353)},
+    {FPoint(1166, 1336), FPoint(875, 743), FPoint(847, 759), FPoint(1138, 1352)},
+    {FPoint(1167, 1337), FPoint(930, 712), FPoint(900, 725), FPoint(1137, 1351)},
+    {FPoint(1167, 1339), FPoint(987, 688), FPoint(957, 698), FPoint(1137, 1349)},
+    {FPoint(1168, 1341), FPoint(1047, 671), FPoint(1015, 677), FPoint(1136, 1347)},
+    {FPoint(1168, 1342), FPoint(1107, 661), FPoint(1075, 665), FPoint(1136, 1346)},
+};
+
+#else
+#error "No geometry for this platform - add it to tools/gen_geometry.py."
+#endif
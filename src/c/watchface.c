@@ -2,10 +2,23 @@
 #include <pebble-fctx/fctx.h>
 #include <pebble-fctx/fpath.h>
 #include <pebble-fctx/ffont.h>
+#include "geometry.h"
 
 // message buffer size:
 #define MESSAGE_BUF 128
 
+// Clock hands rasterizer: 1 - convex polygons scan converted straight into the frame buffer, 0 - pebble-fctx paths.
+// The scanline fill has no antialiasing, which only black and white screens cannot show anyway, so color
+// platforms keep fctx. `make -C tools/host hands` diffs the two.
+#ifndef SCANLINE_HANDS
+#define SCANLINE_HANDS PBL_IF_BW_ELSE(1, 0)
+#endif
+
+// Draw timings and event counters the phone can pull with DEBUG_STATS_KEY. Off in release builds.
+#ifndef STATS_ENABLED
+#define STATS_ENABLED 0
+#endif
+
 // TODO Use `layer_get_frame` instead of hardcoding sizes in callbacks!
 // TODO Add `const` where appropriate!
 
@@ -22,21 +35,57 @@
 // Types and global variables.
 // --------------------------------------------------------------------------
 
+#define BPM_HISTORY_MINUTES 60        // Heart rate history kept for the graph.
+#define BPM_HISTORY_REFETCH_MINUTES 5 // Minute data reaches the health service late, so the newest minutes are re-read on every update.
+#define BPM_HISTORY_CHUNK 15          // Records read per health service call - bounds the stack used by the update.
+#define BPM_GRAPH_COLUMNS 30          // Minutes shown by the heart rate graph.
+#define PRECIP_GRAPH_COLUMNS 45       // Minutes shown by the precipitation graph.
+#define SPARKLINE_GRID 2              // Guide columns a sparkline can have.
+#define HEALTH_COALESCE_MS 3000       // Movement and sleep events come in bursts - one health read per window.
+#define SECONDS_MODE_DURATION 30      // Seconds the seconds hand and the forecast stay on after a tap.
+#define FORECAST_HOURS 24             // Hourly forecast kept for the forecast views.
+#define FORECAST_TEMP_UNKNOWN INT8_MAX
+#define SECONDS_FRAME_BUDGET_MS 40    // Seconds mode frames taking longer than this are slow...
+#define SECONDS_SLOW_FRAMES 3         // ...and this many of them end the seconds mode early.
+#define RESTING_OFF_WRIST_MINUTES 30  // No heart rate for this long means the watch is not worn.
+#define RESTING_REDRAW_MINUTES 15     // The resting face moves its hour hand this often.
+#define RESTING_HOLD (5*SECONDS_PER_MINUTE) // A tap or waking up keeps the full face on at least this long.
+
 static Window* g_window;
-static Layer* g_layer;                        // Main layer updated every minute - clock and health data.
-static Layer* g_battery_layer;                // Layer updated on battery events.
-static Layer* g_connection_layer;             // Layer updated on connection events.
-static TextLayer* g_health_cals_text_layer;   // Layer updated on health events.
-static TextLayer* g_health_meters_text_layer; // Layer updated on health events.
-static TextLayer* g_health_sleep_text_layer;  // Layer updated on health events.
-static TextLayer* g_health_bpm_text_layer;    // Layer updated on heart beat events.
-static Layer* g_health_bpm_graph_layer;       // Layer updated on heart beat events or on minute ticks.
-static Layer* g_weather_temp_layer;           // Layer updated on weather events from PebbleKit messages.
-static Layer* g_weather_icon_layer;           // Layer updated on weather events from PebbleKit messages.
-static Layer* g_weather_precipprob_layer;     // Layer updated on weather events from PebbleKit messages.
-static Layer* g_weather_precipgraph_layer;    // Layer updated on weather events from PebbleKit messages or on minute ticks.
-static TextLayer* g_my_message_layer;         // A reminder about 2016.
+static Layer* g_layer;                        // The only layer - draws the widgets.
+static GFont g_font;                          // Fonts are looked up once and reused by every draw.
+static GFont g_font_time;
+static GFont g_font_date;
+static GBitmap* g_dial_bitmap;                // Pre-rendered pips, blitted by the main layer on every redraw.
+static GSize g_dial_size;                     // Size of the layer the cached dial was rendered for.
+static GBitmap* g_weather_icons_atlas;        // All weather icons, stacked vertically, loaded once.
+static GBitmap* g_weather_icon_view;          // Sub-bitmap of the atlas for the current icon.
+static uint8_t g_weather_icon_view_key;       // The value of `g_weather_icon` that `g_weather_icon_view` shows.
 static struct tm g_local_time;
+static time_t g_seconds_mode_until;           // The seconds hand is shown until then, 0 - not shown.
+static uint8_t g_seconds_slow_frames;         // Frames over budget since the seconds mode started.
+
+// What the precipitation graph shows. Taps cycle through the views while the seconds mode is on.
+typedef enum {
+    PRECIP_VIEW_MINUTELY,     // Precipitation intensity in the next 45 minutes.
+    PRECIP_VIEW_HOURLY_PRECIP, // Precipitation probability in the next 22 hours.
+    PRECIP_VIEW_HOURLY_TEMP,   // Temperature in the next 22 hours.
+    PRECIP_VIEW_COUNT
+} PrecipView;
+
+static PrecipView g_precip_view;
+
+// Why the face is resting - only the dial, the hour hand and the battery are shown and kept up to date.
+typedef enum {
+    RESTING_NONE,      // The full face.
+    RESTING_ASLEEP,    // The health service reports sleep.
+    RESTING_OFF_WRIST, // No heart rate for a while.
+} Resting;
+
+static Resting g_resting;
+static time_t g_resting_hold_until;            // No resting until then.
+static bool g_heart_rate_available;            // Watches without a heart rate monitor are never off-wrist.
+
 static uint8_t g_battery_level;
 static int8_t g_connected; // TODO Should be bool!
 static int8_t g_temp = 101; // TODO Use some more meaningful way to specify "unknown", not just setting it to 101!
@@ -45,9 +94,61 @@ static int8_t g_tempmin = 101;
 static uint8_t g_precipprob;
 static uint8_t g_weather_icon; // TODO Use less obfuscated data type!
 static uint8_t g_weather_precip_array[60];
-static uint8_t g_ticks_since_weather_array_update;
-static AppSync g_sync;
-static uint8_t g_sync_buffer[MESSAGE_BUF];
+static time_t g_weather_time;                      // When the precipitation array was received.
+static time_t g_weather_received;                  // When the last weather message was received.
+static time_t g_weather_requested;                 // When the watch last asked the phone for new weather.
+static uint8_t g_weather_precip_revision;          // Bumped on every new precipitation array.
+static int8_t g_forecast_temps[FORECAST_HOURS];    // Hourly temperature, indexed by hours since the epoch modulo the length.
+static uint8_t g_forecast_precip[FORECAST_HOURS/2]; // Hourly 4 bit precipitation probability, indexed the same, two per byte.
+static time_t g_forecast_start;                    // First hour of the forecast, 0 - no forecast.
+static uint8_t g_forecast_revision;                // Bumped on every new forecast.
+static uint8_t g_bpm_history[BPM_HISTORY_MINUTES]; // Heart rate per minute, indexed by minutes since the epoch modulo the length. 0 - no data.
+static time_t g_bpm_history_end;                   // Minute-aligned time up to which `g_bpm_history` is filled.
+
+// Today's health sums as last shown; -1 until the first read.
+typedef struct {
+    int32_t resting_kcal;
+    int32_t active_kcal;
+    int32_t walked_meters;
+    int32_t sleep;
+    int32_t restful;
+} HealthSnapshot;
+
+static HealthSnapshot g_health = {-1, -1, -1, -1, -1};
+static int32_t g_health_bpm = -1;
+static AppTimer* g_health_timer;                   // Pending health read, NULL when none.
+
+// Weather icons in the order they appear in the atlas (https://icons8.com/ is the icons' source):
+// 1 - Sun, 2 - Bright Moon, 3 - Rain, 4 - Snow, 5 - Sleet, 6 - Air Element (wind), 7 - Dust (fog),
+// 8 - Clouds, 9 - Partly Cloudy Day, 10 - Partly Cloudy Night. 0 means no icon.
+#define WEATHER_ICON_COUNT 10
+
+// Everything drawn on top of the dial, bottom-most first.
+typedef enum {
+    WIDGET_HANDS,               // Updated every minute - hands, time and date.
+    WIDGET_SECONDS,             // Updated every second in the seconds mode.
+    WIDGET_BATTERY,             // Updated on battery events.
+    WIDGET_CONNECTION,          // Updated on connection events.
+    WIDGET_BPM_GRAPH,           // Updated on heart beat events or on minute ticks.
+    WIDGET_BPM_TEXT,            // Updated on heart beat events.
+    WIDGET_HEALTH_METERS,       // Updated on health events.
+    WIDGET_HEALTH_SLEEP,        // Updated on health events.
+    WIDGET_HEALTH_CALS,         // Updated on health events.
+    WIDGET_WEATHER_TEMP,        // Updated on weather events from PebbleKit messages.
+    WIDGET_WEATHER_ICON,        // Updated on weather events from PebbleKit messages.
+    WIDGET_WEATHER_PRECIPPROB,  // Updated on weather events from PebbleKit messages.
+    WIDGET_WEATHER_PRECIPGRAPH, // Updated on weather events from PebbleKit messages or on minute ticks.
+    WIDGET_MY_MESSAGE,          // A reminder about 2016.
+    WIDGET_COUNT
+} WidgetId;
+
+static uint32_t g_fingerprints[WIDGET_COUNT];      // Fingerprint of the inputs each widget was last marked dirty with.
+static uint32_t g_skipped_redraws;                 // Redraws avoided because the inputs did not change.
+
+// Version of the precipitation series encoding understood by `weather_precip_decode`.
+#define PRECIP_ENCODING_VERSION 1
+// Version of the hourly forecast encoding understood by `weather_hourly_decode`.
+#define HOURLY_ENCODING_VERSION 1
 
 enum WeatherKey {
   WEATHER_ICON_KEY = 0x0,
@@ -56,83 +157,741 @@ enum WeatherKey {
   WEATHER_TEMPERATUREMIN_KEY = 0x3,
   WEATHER_PRECIP_PROB_KEY = 0x4,
   WEATHER_PRECIP_ARRAY_KEY = 0x5,
+  WEATHER_REQUEST_KEY = 0x6,        // Sent by the watch when its weather is stale, the value is the battery level.
+  WATCH_BATTERY_KEY = 0x7,          // Sent by the watch when the battery level crosses a multiple of 10%, and in
+                                    // answer to the phone sending it once PebbleKit JS is ready.
+  DEBUG_STATS_KEY = 0x8,            // Sent by the phone to ask for the instrumentation stats, answered with them.
+  WEATHER_HOURLY_KEY = 0x9,
 };
 
+#define WEATHER_STALE_AGE (30*SECONDS_PER_MINUTE)        // Ask the phone for new weather when the last one is older.
+#define WEATHER_REQUEST_INTERVAL (10*SECONDS_PER_MINUTE) // But do not ask more often than this.
+
+// --------------------------------------------------------------------------
+// Instrumentation.
+// --------------------------------------------------------------------------
+
+// Milliseconds on a wrapping clock, for timing draws.
+static uint32_t now_ms() {
+    time_t seconds;
+    uint16_t ms;
+    time_ms(&seconds, &ms);
+    return (uint32_t)seconds*1000 + ms;
+}
+
+// With STATS_ENABLED every widget draw is timed and the event handlers count how often they run.
+// Without it all of this compiles to nothing.
+#if STATS_ENABLED
+
+#define STATS_VERSION 4
+#define STATS_HISTOGRAM_BUCKETS 8 // Draw times of 0, 1, 2-3, 4-7, ..., 32-63 and 64+ ms.
+
+// Sent to the phone as is - `logStats` in index.js reads it back, little endian.
+typedef struct __attribute__((__packed__)) {
+    uint32_t count;
+    uint32_t total_ms;
+    uint16_t max_ms;
+    uint16_t histogram[STATS_HISTOGRAM_BUCKETS];
+} StatsDraw;
+
+typedef struct __attribute__((__packed__)) {
+    uint8_t version;
+    uint32_t uptime;           // Seconds since the watchface started.
+    uint32_t heap_used;
+    uint32_t ticks;
+    uint32_t health_events;
+    uint32_t messages;
+    uint32_t dropped_messages;
+    uint32_t skipped_redraws;
+    uint32_t frames;
+    uint32_t frame_ms;         // Time spent in the layer update proc.
+    uint32_t taps;
+    uint32_t timers;           // App timer callbacks.
+    uint32_t bytes_received;
+    uint32_t messages_sent;    // Not counting the stats.
+    uint32_t bytes_sent;
+    uint32_t health_calls;     // Health service queries.
+    StatsDraw draws[WIDGET_COUNT];
+} Stats;
+
+#define STATS_OUTBOX_BUF (sizeof(Stats) + 16) // The stats and the dictionary header around them.
+
+static Stats g_stats = {.version = STATS_VERSION};
+static time_t g_stats_started;
+
+static void stats_record_draw(WidgetId id, uint32_t elapsed_ms) {
+    StatsDraw* draw = &g_stats.draws[id];
+    int bucket = 0;
+    while (bucket < STATS_HISTOGRAM_BUCKETS-1 && elapsed_ms >> bucket) {
+        bucket++;
+    }
+    if (draw->histogram[bucket] < UINT16_MAX) {
+        draw->histogram[bucket] += 1;
+    }
+    draw->count += 1;
+    draw->total_ms += elapsed_ms;
+    if (elapsed_ms > draw->max_ms) {
+        draw->max_ms = min(elapsed_ms, (uint32_t)UINT16_MAX);
+    }
+}
+
+static void stats_send() {
+    DictionaryIterator* iter;
+    if (app_message_outbox_begin(&iter) != APP_MSG_OK) {
+        return;
+    }
+    g_stats.uptime = time(NULL) - g_stats_started;
+    g_stats.heap_used = heap_bytes_used();
+    g_stats.skipped_redraws = g_skipped_redraws;
+    dict_write_data(iter, DEBUG_STATS_KEY, (const uint8_t*)&g_stats, sizeof g_stats);
+    app_message_outbox_send();
+}
+
+#define STATS_DRAW_BEGIN() uint32_t stats_draw_start = now_ms()
+#define STATS_DRAW_END(id) stats_record_draw(id, now_ms() - stats_draw_start)
+#define STATS_ADD(counter, n) (g_stats.counter += (n))
+#define STATS_COUNT(counter) STATS_ADD(counter, 1)
+#define STATS_START() (g_stats_started = time(NULL))
+
+#else
+
+#define STATS_OUTBOX_BUF MESSAGE_BUF
+#define STATS_DRAW_BEGIN()
+#define STATS_DRAW_END(id)
+#define STATS_ADD(counter, n)
+#define STATS_COUNT(counter)
+#define STATS_START()
+
+#endif
+
+// --------------------------------------------------------------------------
+// Weather data decoding.
+// --------------------------------------------------------------------------
+
+// Read an integer tuple of any width - PebbleKit JS sends plain numbers as 32 bit integers.
+// Returns false, leaving `value` alone, for tuples that are not integers of a valid length.
+static bool tuple_read_int(const Tuple* tuple, int32_t* value) {
+    if (tuple->type != TUPLE_INT && tuple->type != TUPLE_UINT) {
+        return false;
+    }
+    bool is_signed = tuple->type == TUPLE_INT;
+    switch (tuple->length) {
+        case 1: *value = is_signed ? tuple->value->int8 : tuple->value->uint8; return true;
+        case 2: *value = is_signed ? tuple->value->int16 : tuple->value->uint16; return true;
+        case 4: *value = is_signed ? tuple->value->int32 : (int32_t)tuple->value->uint32; return true;
+        default: return false;
+    }
+}
+
+// Decode a precipitation series as produced by `encodePrecip` in index.js: a version byte followed by runs,
+// one byte each - the high nibble is the run length minus one, the low nibble the 4 bit intensity level.
+// Levels are scaled back to the 0-255 range the graph works with. Returns false on an unknown version.
+static bool weather_precip_decode(const uint8_t* data, uint16_t length) {
+    if (length < 1 || data[0] != PRECIP_ENCODING_VERSION) {
+        return false;
+    }
+    int i = 0;
+    for (int r = 1; r < length && i < (int)sizeof g_weather_precip_array; r++) {
+        int run = (data[r] >> 4) + 1;
+        uint8_t value = (data[r] & 0x0f) * 17;
+        for (; run > 0 && i < (int)sizeof g_weather_precip_array; run--) {
+            g_weather_precip_array[i++] = value;
+        }
+    }
+    memset(&g_weather_precip_array[i], 0, sizeof g_weather_precip_array - i);
+    return true;
+}
+
+// Minutes between the start of the precipitation array and the current minute, saturating past the array's end.
+static int weather_precip_offset() {
+    int32_t minutes = time(NULL) / SECONDS_PER_MINUTE - g_weather_time / SECONDS_PER_MINUTE;
+    return min(max(minutes, 0), (int32_t)sizeof g_weather_precip_array);
+}
+
+// Decode an hourly forecast as produced by `encodeHourly` in index.js: a version byte, the first hour as a
+// little endian 32 bit time, FORECAST_HOURS temperatures as signed bytes and FORECAST_HOURS 4 bit
+// precipitation probabilities, two per byte with the earlier hour in the low nibble. Returns false on an
+// unknown version or length.
+static bool weather_hourly_decode(const uint8_t* data, uint16_t length) {
+    if (length != 1 + 4 + FORECAST_HOURS + FORECAST_HOURS/2 || data[0] != HOURLY_ENCODING_VERSION) {
+        return false;
+    }
+    time_t start = data[1] | data[2] << 8 | data[3] << 16 | (uint32_t)data[4] << 24;
+    start -= start % SECONDS_PER_HOUR;
+    memset(g_forecast_precip, 0, sizeof g_forecast_precip);
+    for (int i = 0; i < FORECAST_HOURS; i++) {
+        int slot = (start / SECONDS_PER_HOUR + i) % FORECAST_HOURS;
+        uint8_t precip = (data[1 + 4 + FORECAST_HOURS + i/2] >> (i%2 * 4)) & 0x0f;
+        g_forecast_temps[slot] = (int8_t)data[1 + 4 + i];
+        g_forecast_precip[slot/2] |= precip << (slot%2 * 4);
+    }
+    g_forecast_start = start;
+    return true;
+}
+
+// The forecast for the hour starting at `hour`. Returns false for hours the forecast does not cover.
+static bool weather_forecast_at(time_t hour, int8_t* temp, uint8_t* precip) {
+    if (!g_forecast_start || hour < g_forecast_start || hour >= g_forecast_start + FORECAST_HOURS*SECONDS_PER_HOUR) {
+        return false;
+    }
+    int slot = (hour / SECONDS_PER_HOUR) % FORECAST_HOURS;
+    *temp = g_forecast_temps[slot];
+    *precip = (g_forecast_precip[slot/2] >> (slot%2 * 4)) & 0x0f;
+    return *temp != FORECAST_TEMP_UNKNOWN;
+}
+
+// --------------------------------------------------------------------------
+// Heart rate history.
+// --------------------------------------------------------------------------
+
+// Top up the heart rate history with the minutes since the last update. Only the whole hour is read on
+// the first call; afterwards every minute tick costs a single short health service query.
+static void bpm_history_update() {
+    time_t now = time(NULL);
+    time_t end = now - now % SECONDS_PER_MINUTE;
+    if (end < g_bpm_history_end) { // The clock went backwards - start over.
+        g_bpm_history_end = 0;
+    }
+    time_t start = max(g_bpm_history_end - BPM_HISTORY_REFETCH_MINUTES*SECONDS_PER_MINUTE,
+                       end - BPM_HISTORY_MINUTES*SECONDS_PER_MINUTE);
+    // Slots after the old end still hold samples from an hour ago.
+    for (time_t t = max(g_bpm_history_end, start); t < end; t += SECONDS_PER_MINUTE) {
+        g_bpm_history[(t / SECONDS_PER_MINUTE) % BPM_HISTORY_MINUTES] = 0;
+    }
+    HealthMinuteData minute_data[BPM_HISTORY_CHUNK];
+    for (time_t t = start; t < end; t += BPM_HISTORY_CHUNK*SECONDS_PER_MINUTE) {
+        time_t t1 = t;
+        time_t t2 = min(t + BPM_HISTORY_CHUNK*SECONDS_PER_MINUTE, end);
+        uint32_t count = health_service_get_minute_history(minute_data, BPM_HISTORY_CHUNK, &t1, &t2);
+        STATS_COUNT(health_calls);
+        for (uint32_t i = 0; i < count; i++) {
+            g_bpm_history[(t1 / SECONDS_PER_MINUTE + i) % BPM_HISTORY_MINUTES] = minute_data[i].is_invalid ? 0 : minute_data[i].heart_rate_bpm;
+        }
+    }
+    g_bpm_history_end = end;
+}
+
+// --------------------------------------------------------------------------
+// Persistent snapshot.
+// --------------------------------------------------------------------------
+
+// The last weather and the heart rate history survive a watchface switch, so the first frame is complete
+// even before the phone answers. Precipitation is kept as the 4 bit levels it was sent with.
+#define SNAPSHOT_KEY 1
+#define SNAPSHOT_VERSION 3
+#define SNAPSHOT_WEATHER_MAX_AGE (2*SECONDS_PER_HOUR) // Older weather is not worth showing.
+
+typedef struct __attribute__((__packed__)) {
+    uint8_t version;
+    int8_t temp;
+    int8_t tempmax;
+    int8_t tempmin;
+    uint8_t precipprob;
+    uint8_t weather_icon;
+    uint32_t weather_received;
+    uint32_t weather_time;
+    uint8_t precip_levels[30]; // Two 4 bit levels per byte, first sample in the low nibble.
+    uint32_t bpm_history_end;
+    uint8_t bpm_history[BPM_HISTORY_MINUTES];
+    uint32_t forecast_start;
+    int8_t forecast_temps[FORECAST_HOURS];
+    uint8_t forecast_precip[FORECAST_HOURS/2];
+} Snapshot;
+
+static void snapshot_save() {
+    Snapshot snapshot = {
+        .version = SNAPSHOT_VERSION,
+        .temp = g_temp,
+        .tempmax = g_tempmax,
+        .tempmin = g_tempmin,
+        .precipprob = g_precipprob,
+        .weather_icon = g_weather_icon,
+        .weather_received = g_weather_received,
+        .weather_time = g_weather_time,
+        .bpm_history_end = g_bpm_history_end,
+        .forecast_start = g_forecast_start,
+    };
+    for (int i = 0; i < (int)sizeof snapshot.precip_levels; i++) {
+        snapshot.precip_levels[i] = g_weather_precip_array[2*i]/17 | (g_weather_precip_array[2*i+1]/17) << 4;
+    }
+    memcpy(snapshot.bpm_history, g_bpm_history, sizeof snapshot.bpm_history);
+    memcpy(snapshot.forecast_temps, g_forecast_temps, sizeof snapshot.forecast_temps);
+    memcpy(snapshot.forecast_precip, g_forecast_precip, sizeof snapshot.forecast_precip);
+    persist_write_data(SNAPSHOT_KEY, &snapshot, sizeof snapshot);
+}
+
+static void snapshot_restore() {
+    Snapshot snapshot;
+    if (persist_read_data(SNAPSHOT_KEY, &snapshot, sizeof snapshot) != sizeof snapshot || snapshot.version != SNAPSHOT_VERSION) {
+        return;
+    }
+    time_t now = time(NULL);
+    time_t weather_received = snapshot.weather_received;
+    if (weather_received <= now && now - weather_received < SNAPSHOT_WEATHER_MAX_AGE) {
+        g_temp = snapshot.temp;
+        g_tempmax = snapshot.tempmax;
+        g_tempmin = snapshot.tempmin;
+        g_precipprob = snapshot.precipprob;
+        g_weather_icon = snapshot.weather_icon;
+        g_weather_received = weather_received;
+        g_weather_time = snapshot.weather_time;
+        for (int i = 0; i < (int)sizeof snapshot.precip_levels; i++) {
+            g_weather_precip_array[2*i] = (snapshot.precip_levels[i] & 0x0f) * 17;
+            g_weather_precip_array[2*i+1] = (snapshot.precip_levels[i] >> 4) * 17;
+        }
+    }
+    time_t bpm_history_end = snapshot.bpm_history_end;
+    if (bpm_history_end <= now) {
+        g_bpm_history_end = bpm_history_end;
+        memcpy(g_bpm_history, snapshot.bpm_history, sizeof g_bpm_history);
+    }
+    time_t forecast_start = snapshot.forecast_start;
+    if (forecast_start <= now && now < forecast_start + FORECAST_HOURS*SECONDS_PER_HOUR) {
+        g_forecast_start = forecast_start;
+        memcpy(g_forecast_temps, snapshot.forecast_temps, sizeof g_forecast_temps);
+        memcpy(g_forecast_precip, snapshot.forecast_precip, sizeof g_forecast_precip);
+    }
+}
+
+// --------------------------------------------------------------------------
+// Dial cache.
+// --------------------------------------------------------------------------
+
+// The pips never change, so they are tessellated only once and afterwards the main layer just blits them.
+// Their outlines come precomputed from geometry.h.
+static void draw_dial(FContext* fctx) {
+    fctx_set_fill_color(fctx, GColorWhite);
+    fctx_begin_fill(fctx);
+    for (int m = 0; m < 60; ++m) {
+        const FPoint* pip = PIP_POLYGONS[m];
+        fctx_move_to(fctx, pip[0]);
+        fctx_line_to(fctx, pip[1]);
+        fctx_line_to(fctx, pip[2]);
+        if (0 != m % 5) {
+            fctx_line_to(fctx, pip[3]);
+        }
+        fctx_close_path(fctx);
+    }
+    fctx_end_fill(fctx);
+}
+
+// Antialiased white pips on black only ever blend into grays, so four of them hold the dial without loss.
+// A 2 bit cache takes a quarter of the memory of an 8 bit copy of the frame buffer.
+static GColor g_dial_palette[4];
+
+// Copy the frame buffer into the dial cache. Must be called right after `draw_dial`, while the frame
+// holds nothing but the background and the pips. Black and white frame buffers are copied as they are,
+// color ones are reduced to `g_dial_palette`.
+static void dial_cache_store(GContext* ctx, GSize size) {
+    if (g_dial_bitmap && (g_dial_size.w != size.w || g_dial_size.h != size.h)) {
+        gbitmap_destroy(g_dial_bitmap);
+        g_dial_bitmap = NULL;
+    }
+    GBitmap* fb = graphics_capture_frame_buffer(ctx);
+    if (!fb) {
+        return;
+    }
+    bool bw = gbitmap_get_format(fb) == GBitmapFormat1Bit;
+    if (!g_dial_bitmap) {
+        if (bw) {
+            g_dial_bitmap = gbitmap_create_blank(size, GBitmapFormat1Bit);
+        } else {
+            g_dial_palette[0] = GColorBlack;
+            g_dial_palette[1] = GColorDarkGray;
+            g_dial_palette[2] = GColorLightGray;
+            g_dial_palette[3] = GColorWhite;
+            g_dial_bitmap = gbitmap_create_blank_with_palette(size, GBitmapFormat2BitPalette, g_dial_palette, false);
+        }
+        g_dial_size = size;
+    }
+    if (g_dial_bitmap) {
+        uint8_t* src = gbitmap_get_data(fb);
+        uint8_t* dst = gbitmap_get_data(g_dial_bitmap);
+        uint16_t src_row = gbitmap_get_bytes_per_row(fb);
+        uint16_t dst_row = gbitmap_get_bytes_per_row(g_dial_bitmap);
+        for (int y = 0; y < size.h; ++y) {
+            if (bw) {
+                memcpy(dst + y*dst_row, src + y*src_row, min(src_row, dst_row));
+                continue;
+            }
+            // Four pixels per byte, the leftmost in the high bits; the palette index is the gray level.
+            memset(dst + y*dst_row, 0, dst_row);
+            for (int x = 0; x < size.w; ++x) {
+                GColor color = {.argb = src[y*src_row + x]};
+                uint8_t level = (color.r + color.g + color.b + 1) / 3;
+                dst[y*dst_row + x/4] |= level << (6 - 2*(x%4));
+            }
+        }
+    }
+    graphics_release_frame_buffer(ctx, fb);
+}
+
+// Reset a part of the screen to the bare dial.
+static void dial_cache_restore(GContext* ctx, GRect rect) {
+    if (!g_dial_bitmap) {
+        return;
+    }
+    GRect bounds = gbitmap_get_bounds(g_dial_bitmap);
+    grect_clip(&rect, &bounds);
+    if (grect_is_empty(&rect)) {
+        return;
+    }
+    gbitmap_set_bounds(g_dial_bitmap, rect);
+    graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+    graphics_draw_bitmap_in_rect(ctx, g_dial_bitmap, rect);
+    gbitmap_set_bounds(g_dial_bitmap, bounds);
+}
+
 // --------------------------------------------------------------------------
-// Utility functions.
+// Frame buffer rasterizer.
 // --------------------------------------------------------------------------
 
-static inline FPoint clockToCartesian(FPoint center, fixed_t w, fixed_t h, int32_t angle) {
-    FPoint pt;
+// Fill the pixels x0..x1 of row y. Black and white frame buffers get gray as a 50% checkerboard.
+static void fb_fill_span(GBitmap* fb, int y, int x0, int x1, GColor color) {
+    if (y < 0 || y >= gbitmap_get_bounds(fb).size.h) {
+        return;
+    }
+    GBitmapDataRowInfo row = gbitmap_get_data_row_info(fb, y);
+    x0 = max(x0, (int)row.min_x);
+    x1 = min(x1, (int)row.max_x);
+    if (x0 > x1) {
+        return;
+    }
+    if (gbitmap_get_format(fb) == GBitmapFormat1Bit) {
+        bool gray = !gcolor_equal(color, GColorWhite) && !gcolor_equal(color, GColorBlack);
+        for (int x = x0; x <= x1; x++) {
+            bool white = gray ? ((x + y) & 1) : gcolor_equal(color, GColorWhite);
+            if (white) {
+                row.data[x / 8] |= 1 << (x % 8);
+            } else {
+                row.data[x / 8] &= ~(1 << (x % 8));
+            }
+        }
+    } else {
+        memset(row.data + x0, color.argb, x1 - x0 + 1);
+    }
+}
+
+// Integer division rounding towards minus infinity - plain `/` rounds towards zero.
+static inline int32_t floor_div(int32_t a, int32_t b) {
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+// Scan convert a convex polygon given in fixed point: a pixel is filled when its center is inside.
+static void fb_fill_convex(GBitmap* fb, const FPoint* points, int count, GColor color) {
+    fixed_t top = points[0].y;
+    fixed_t bottom = points[0].y;
+    for (int i = 1; i < count; i++) {
+        top = min(top, points[i].y);
+        bottom = max(bottom, points[i].y);
+    }
+    int y_first = -floor_div(FIXED_POINT_SCALE/2 - top, FIXED_POINT_SCALE);
+    for (int y = max(y_first, 0); INT_TO_FIXED(y) + FIXED_POINT_SCALE/2 < bottom; y++) {
+        fixed_t yc = INT_TO_FIXED(y) + FIXED_POINT_SCALE/2;
+        fixed_t left = INT32_MAX;
+        fixed_t right = INT32_MIN;
+        for (int i = 0; i < count; i++) {
+            FPoint a = points[i];
+            FPoint b = points[(i + 1) % count];
+            if ((a.y <= yc && b.y > yc) || (b.y <= yc && a.y > yc)) {
+                fixed_t x = a.x + (yc - a.y) * (b.x - a.x) / (b.y - a.y);
+                left = min(left, x);
+                right = max(right, x);
+            }
+        }
+        if (left <= right) {
+            // Pixel x is filled when left <= x + 1/2 <= right.
+            int x0 = -floor_div(FIXED_POINT_SCALE/2 - left, FIXED_POINT_SCALE);
+            int x1 = floor_div(right - FIXED_POINT_SCALE/2, FIXED_POINT_SCALE);
+            fb_fill_span(fb, y, x0, x1, color);
+        }
+    }
+}
+
+#if SCANLINE_HANDS
+static void fb_fill_disc(GBitmap* fb, FPoint center, fixed_t radius, GColor color) {
+    for (int y = FIXED_TO_INT(center.y - radius); y <= FIXED_TO_INT(center.y + radius); y++) {
+        fixed_t dy = INT_TO_FIXED(y) + FIXED_POINT_SCALE/2 - center.y;
+        int x0 = INT32_MAX;
+        int x1 = INT32_MIN;
+        for (int x = FIXED_TO_INT(center.x - radius); x <= FIXED_TO_INT(center.x + radius); x++) {
+            fixed_t dx = INT_TO_FIXED(x) + FIXED_POINT_SCALE/2 - center.x;
+            if (dx*dx + dy*dy <= radius*radius) {
+                x0 = min(x0, x);
+                x1 = max(x1, x);
+            }
+        }
+        if (x0 <= x1) {
+            fb_fill_span(fb, y, x0, x1, color);
+        }
+    }
+}
+#endif
+
+// The hour hand outline, transformed the way pebble-fctx would with the given scale, rotation and offset:
+// a kite with its tip at `length` (before scaling) and its short end 15 pixels behind the center.
+static void hour_hand_polygon(FPoint points[4], FPoint center, FPoint scale, fixed_t length, int32_t angle) {
+    const FPoint outline[4] = {FPointI(0, -15), FPointI(15, 0), FPoint(0, length), FPointI(-15, 0)};
     int32_t c = cos_lookup(angle);
     int32_t s = sin_lookup(angle);
-    pt.x = center.x + s * w / TRIG_MAX_RATIO;
-    pt.y = center.y - c * h / TRIG_MAX_RATIO;
-    return pt;
+    for (int i = 0; i < 4; i++) {
+        int32_t x = outline[i].x * scale.x / length;
+        int32_t y = outline[i].y * scale.y / length;
+        points[i] = FPoint(center.x + (x*c - y*s) / TRIG_MAX_RATIO, center.y + (x*s + y*c) / TRIG_MAX_RATIO);
+    }
 }
 
 // --------------------------------------------------------------------------
-// The main drawing function.
+// Sparkline graphs.
 // --------------------------------------------------------------------------
 
-static void on_layer_update(Layer* layer, GContext* ctx) {
-    GRect bounds = layer_get_bounds(layer);
-    int16_t w = bounds.size.w;
-    int16_t h = bounds.size.h;
-    FPoint center = FPointI(w / 2, h / 2);
-    fixed_t f_w = INT_TO_FIXED(w);
-    fixed_t f_h = INT_TO_FIXED(h);
-    int32_t minute_angle = g_local_time.tm_min * TRIG_MAX_ANGLE / 60;
-    int32_t hour_angle   = (g_local_time.tm_hour % 12) * TRIG_MAX_ANGLE / 12
-                         +  g_local_time.tm_min        * TRIG_MAX_ANGLE / (12 * 60)
-                         +  TRIG_MAX_ANGLE/2;
+// A bar graph in a white outline, drawn in a single pass over the frame buffer. All coordinates except
+// `frame` are relative to the frame; bars grow up from the bottom row inside the outline.
+typedef struct {
+    GRect frame;                            // Outline, in screen coordinates.
+    const uint8_t* heights;                 // Bar height in pixels per column, 0 - no bar. Clipped to the plot.
+    uint8_t count;
+    uint8_t bar_x;                          // Column of the first bar.
+    int8_t grid_row;                        // Gray guide row under the bars, -1 for none.
+    uint8_t grid_columns[SPARKLINE_GRID];   // Gray guide columns over the bars, 0 for none.
+    GRect shade;                            // Gray area over the bars, e.g. to mark missing data.
+} Sparkline;
+
+static void sparkline_draw(GContext* ctx, const Sparkline* spark) {
+    GBitmap* fb = graphics_capture_frame_buffer(ctx);
+    if (!fb) {
+        return;
+    }
+    int x = spark->frame.origin.x;
+    int y = spark->frame.origin.y;
+    int w = spark->frame.size.w;
+    int h = spark->frame.size.h;
+    fb_fill_span(fb, y, x, x + w - 1, GColorWhite);
+    for (int row = 1; row < h - 1; row++) {
+        if (row == spark->grid_row) {
+            fb_fill_span(fb, y + row, x + 1, x + w - 2, GColorDarkGray);
+        }
+        // Bars reaching this row, merged into spans.
+        int min_height = h - 1 - row;
+        for (int i = 0; i < spark->count; i++) {
+            if (spark->heights[i] < min_height) {
+                continue;
+            }
+            int run = i;
+            while (run + 1 < spark->count && spark->heights[run + 1] >= min_height) {
+                run++;
+            }
+            fb_fill_span(fb, y + row, x + spark->bar_x + i, min(x + spark->bar_x + run, x + w - 2), GColorWhite);
+            i = run;
+        }
+        for (int g = 0; g < SPARKLINE_GRID && spark->grid_columns[g]; g++) {
+            fb_fill_span(fb, y + row, x + spark->grid_columns[g], x + spark->grid_columns[g], GColorDarkGray);
+        }
+        if (row >= spark->shade.origin.y && row < spark->shade.origin.y + spark->shade.size.h) {
+            fb_fill_span(fb, y + row, x + spark->shade.origin.x, x + spark->shade.origin.x + spark->shade.size.w - 1, GColorDarkGray);
+        }
+        fb_fill_span(fb, y + row, x, x, GColorWhite);
+        fb_fill_span(fb, y + row, x + w - 1, x + w - 1, GColorWhite);
+    }
+    fb_fill_span(fb, y + h - 1, x, x + w - 1, GColorWhite);
+    graphics_release_frame_buffer(ctx, fb);
+}
+
+// --------------------------------------------------------------------------
+// Text formatting.
+// --------------------------------------------------------------------------
+
+// Minimal formatters used instead of snprintf and strftime, which bring newlib's formatting code into the
+// binary and are slow on the watch. Each appends to the text ending at `p` without going past `end` - the
+// last byte is always left for the terminating zero - and returns the new end of the text.
+
+static const char* const MONTH_NAMES[12] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+static char* append_text(char* p, char* end, const char* text) {
+    while (*text && p < end - 1) {
+        *p++ = *text++;
+    }
+    *p = '\0';
+    return p;
+}
+
+// Decimal integer, zero padded to at least `digits` digits.
+static char* append_int(char* p, char* end, int32_t value, int digits) {
+    char reversed[10];
+    int n = 0;
+    uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+    do {
+        reversed[n++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while ((magnitude || n < digits) && n < (int)sizeof reversed);
+    if (value < 0 && p < end - 1) {
+        *p++ = '-';
+    }
+    while (n > 0 && p < end - 1) {
+        *p++ = reversed[--n];
+    }
+    *p = '\0';
+    return p;
+}
+
+// A non-negative fixed point `value` in units of 1/`unit`, with one truncated decimal: 1250/1000 is "1.2".
+static char* append_decimal(char* p, char* end, int32_t value, int32_t unit) {
+    p = append_int(p, end, value / unit, 1);
+    p = append_text(p, end, ".");
+    return append_int(p, end, (value % unit) * 10 / unit, 1);
+}
+
+// Like strftime's "%H:%M".
+static char* append_time(char* p, char* end, const struct tm* time) {
+    p = append_int(p, end, time->tm_hour, 2);
+    p = append_text(p, end, ":");
+    return append_int(p, end, time->tm_min, 2);
+}
+
+// Like strftime's "%b %d" in the C locale.
+static char* append_date(char* p, char* end, const struct tm* time) {
+    p = append_text(p, end, MONTH_NAMES[time->tm_mon % 12]);
+    p = append_text(p, end, " ");
+    return append_int(p, end, time->tm_mday, 2);
+}
+
+// The text a widget last drew, formatted when its data changes rather than on every draw, so widgets
+// can be left alone when their text stays the same.
+#define TEXT_SLOT_SIZE 20
+
+typedef struct {
+    char text[TEXT_SLOT_SIZE];
+} TextSlot;
+
+// Returns whether the text changed.
+static bool text_slot_set(TextSlot* slot, const char* text) {
+    if (strncmp(slot->text, text, TEXT_SLOT_SIZE - 1) == 0) {
+        return false;
+    }
+    strncpy(slot->text, text, TEXT_SLOT_SIZE - 1);
+    slot->text[TEXT_SLOT_SIZE - 1] = '\0';
+    return true;
+}
+
+static TextSlot g_time_text;
+static TextSlot g_date_text;
+static TextSlot g_temp_texts[3];  // Current, maximum and minimum temperature, empty while unknown.
+static TextSlot g_precipprob_text; // Empty when there is no chance of precipitation.
+
+// --------------------------------------------------------------------------
+// Widget drawing functions. They get their widget's rect in screen coordinates.
+// --------------------------------------------------------------------------
+
+static bool rect_overlaps(GRect a, GRect b) {
+    return a.origin.x < b.origin.x + b.size.w && b.origin.x < a.origin.x + a.size.w
+        && a.origin.y < b.origin.y + b.size.h && b.origin.y < a.origin.y + a.size.h;
+}
+
+// Bounding rect of both, an empty rect does not count.
+static GRect rect_union(GRect a, GRect b) {
+    if (grect_is_empty(&a)) {
+        return b;
+    }
+    if (grect_is_empty(&b)) {
+        return a;
+    }
+    int x0 = min(a.origin.x, b.origin.x);
+    int y0 = min(a.origin.y, b.origin.y);
+    int x1 = max(a.origin.x + a.size.w, b.origin.x + b.size.w);
+    int y1 = max(a.origin.y + a.size.h, b.origin.y + b.size.h);
+    return GRect(x0, y0, x1 - x0, y1 - y0);
+}
+
+// The resting face moves the hour hand in steps of `RESTING_REDRAW_MINUTES`.
+static int32_t hour_hand_angle() {
+    int minutes = g_resting ? g_local_time.tm_min - g_local_time.tm_min % RESTING_REDRAW_MINUTES : g_local_time.tm_min;
+    return (g_local_time.tm_hour % 12) * TRIG_MAX_ANGLE / 12
+         +  minutes                    * TRIG_MAX_ANGLE / (12 * 60)
+         +  TRIG_MAX_ANGLE/2;
+}
+
+// Pixels a polygon can touch, with a pixel of margin for antialiasing.
+static GRect polygon_rect(const FPoint* points, int count) {
+    fixed_t left = points[0].x, right = points[0].x, top = points[0].y, bottom = points[0].y;
+    for (int i = 1; i < count; i++) {
+        left = min(left, points[i].x);
+        right = max(right, points[i].x);
+        top = min(top, points[i].y);
+        bottom = max(bottom, points[i].y);
+    }
+    int x0 = FIXED_TO_INT(left) - 1;
+    int y0 = FIXED_TO_INT(top) - 1;
+    return GRect(x0, y0, FIXED_TO_INT(right) + 2 - x0, FIXED_TO_INT(bottom) + 2 - y0);
+}
+
+// Everything `render_hands` draws for the current time.
+static GRect hands_rect() {
+    GSize size = GEOMETRY_SCREEN_SIZE;
+    fixed_t f_w = INT_TO_FIXED(size.w);
+    fixed_t f_h = INT_TO_FIXED(size.h);
+    FPoint hour_hand[4];
+    hour_hand_polygon(hour_hand, GEOMETRY_DIAL_CENTER, FPoint(f_w*13/50, f_h*13/50), f_h, hour_hand_angle());
+    if (g_resting) {
+        return polygon_rect(hour_hand, 4);
+    }
+    GRect rect = rect_union(polygon_rect(hour_hand, 4), polygon_rect(MINUTE_HAND[g_local_time.tm_min], 3));
+    return rect_union(rect_union(rect, LAYOUT_TIME), LAYOUT_DATE);
+}
+
+static GRect seconds_rect() {
+    return g_seconds_mode_until ? polygon_rect(SECOND_HAND[g_local_time.tm_sec], 4) : GRectZero;
+}
 
+static void render_hands(GContext* ctx, GRect rect, void* data) {
+    GSize size = GEOMETRY_SCREEN_SIZE;
+    FPoint center = GEOMETRY_DIAL_CENTER;
+    fixed_t f_w = INT_TO_FIXED(size.w);
+    fixed_t f_h = INT_TO_FIXED(size.h);
+    int32_t hour_angle = hour_hand_angle();
+
+#if SCANLINE_HANDS
+    GBitmap* fb = graphics_capture_frame_buffer(ctx);
+    if (fb) {
+        // Draw the minute hand.
+        if (!g_resting) {
+            fb_fill_convex(fb, MINUTE_HAND[g_local_time.tm_min], 3, GColorDarkGray);
+        }
+
+        // Draw the hour hand.
+        FPoint hour_hand[4];
+        hour_hand_polygon(hour_hand, center, FPoint(f_w*13/50, f_h*13/50), f_h, hour_angle);
+        fb_fill_convex(fb, hour_hand, 4, GColorBlack);
+        hour_hand_polygon(hour_hand, center, FPoint(f_w/5, f_h/5), f_h, hour_angle);
+        fb_fill_convex(fb, hour_hand, 4, GColorWhite);
+
+        // Draw the center.
+        fb_fill_disc(fb, center, INT_TO_FIXED(1), GColorBlack);
+        graphics_release_frame_buffer(ctx, fb);
+    }
+#else
+    // Antialiased edges would build up when drawn over themselves - start from the bare dial. Nothing
+    // but the dial is under the hands, so this wipes no other widget.
+    dial_cache_restore(ctx, rect);
     FContext fctx;
     fctx_init_context(&fctx, ctx);
     fctx_set_color_bias(&fctx, 0);
-    
-    // Draw the pips.
-    fctx_set_fill_color(&fctx, GColorWhite);
-    fctx_begin_fill(&fctx);
-    for (int m = 0; m < 60; ++m) {
-        int32_t angle = m * TRIG_MAX_ANGLE / 60;
-        FPoint p = clockToCartesian(center, f_w/3, f_h/3, angle);
-        fctx_set_offset(&fctx, p);
-        fctx_set_rotation(&fctx, angle);
-        if (0 == m % 15) {
-            fctx_move_to(&fctx, FPointI( 0,   2));
-            fctx_line_to(&fctx, FPointI( 3, -10));
-            fctx_line_to(&fctx, FPointI(-3, -10));
-            fctx_close_path(&fctx);
-        } else if (0 == m % 5) {
-            fctx_move_to(&fctx, FPointI( 0,  0));
-            fctx_line_to(&fctx, FPointI( 2, -6));
-            fctx_line_to(&fctx, FPointI(-2, -6));
-            fctx_close_path(&fctx);
-        } else {
-            fctx_move_to(&fctx, FPointI(0,  0));
-            fctx_line_to(&fctx, FPointI(0, -3));
-            fctx_line_to(&fctx, FPointI(1, -3));
-            fctx_line_to(&fctx, FPointI(1,  0));
-            fctx_close_path(&fctx);
-        }
-    }
-    fctx_end_fill(&fctx);
-    
+
     // Draw the minute hand.
-    fctx_begin_fill(&fctx);
-    fctx_set_offset(&fctx, FPoint(0,0));
-    fctx_set_scale(&fctx, FPoint(f_h, f_h), FPoint(f_h, f_h));
-    fctx_set_rotation(&fctx, 0);
-    FPoint minute_p = clockToCartesian(center, f_w/3, f_h/3, minute_angle);
-    FPoint minute_p1 = clockToCartesian(center, f_w*8/30, f_h*8/30, minute_angle+TRIG_MAX_ANGLE/60);
-    FPoint minute_p2 = clockToCartesian(center, f_w*8/30, f_h*8/30, minute_angle-TRIG_MAX_ANGLE/60);
-    fctx_set_fill_color(&fctx, GColorDarkGray);
-    fctx_move_to(&fctx, minute_p);
-    fctx_line_to(&fctx, minute_p1);
-    fctx_line_to(&fctx, minute_p2);
-    fctx_close_path(&fctx);    
-    fctx_end_fill(&fctx);
+    if (!g_resting) {
+        fctx_begin_fill(&fctx);
+        fctx_set_offset(&fctx, FPoint(0,0));
+        fctx_set_scale(&fctx, FPoint(f_h, f_h), FPoint(f_h, f_h));
+        fctx_set_rotation(&fctx, 0);
+        const FPoint* minute_hand = MINUTE_HAND[g_local_time.tm_min];
+        fctx_set_fill_color(&fctx, GColorDarkGray);
+        fctx_move_to(&fctx, minute_hand[0]);
+        fctx_line_to(&fctx, minute_hand[1]);
+        fctx_line_to(&fctx, minute_hand[2]);
+        fctx_close_path(&fctx);
+        fctx_end_fill(&fctx);
+    }
 
     // Draw the hour hand.
     fctx_set_scale(&fctx, FPoint(f_h, f_h), FPoint(f_w*13/50, f_h*13/50));
@@ -157,251 +916,819 @@ static void on_layer_update(Layer* layer, GContext* ctx) {
     fctx_close_path(&fctx);
     fctx_end_fill(&fctx);
   
-    // Draw the center.
+    // Draw the center. The circle is given in screen coordinates - undo the hour hand's offset and rotation.
     fctx_begin_fill(&fctx);
+    fctx_set_offset(&fctx, FPoint(0,0));
     fctx_set_scale(&fctx, FPoint(f_w, f_h), FPoint(f_w, f_h));
+    fctx_set_rotation(&fctx, 0);
     fctx_set_fill_color(&fctx, GColorBlack);
     fctx_plot_circle(&fctx, &center, INT_TO_FIXED(1));
     fctx_end_fill(&fctx);
 
     fctx_deinit_context(&fctx);
+#endif
+
+    if (g_resting) {
+        return;
+    }
 
     // Draw the time.
-    char time_string[6];
-    strftime(time_string, sizeof time_string, "%H:%M", &g_local_time);
-    graphics_draw_text(ctx, time_string,
-                       fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD),
-                       GRect(w/3,h*2/3-18,w/3,18), GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+    graphics_draw_text(ctx, g_time_text.text, g_font_time,
+                       LAYOUT_TIME, GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
 
     // Draw the date.
-    char date_string[7];
-    strftime(date_string, sizeof date_string, "%b %d", &g_local_time);
-    graphics_draw_text(ctx, date_string,
-                       fonts_get_system_font(FONT_KEY_GOTHIC_14_BOLD),
-                       GRect(w/3,h*2/3,w/3,15), GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+    graphics_draw_text(ctx, g_date_text.text, g_font_date,
+                       LAYOUT_DATE, GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
 }
 
-static void on_battery_layer_update(Layer* layer, GContext* ctx) {
-    GRect bounds = layer_get_bounds(layer);
-    int BAT_W = bounds.size.w;
-    int BAT_H = bounds.size.h-2;
+static void render_seconds(GContext* ctx, GRect rect, void* data) {
+    if (!g_seconds_mode_until) {
+        return;
+    }
+    GBitmap* fb = graphics_capture_frame_buffer(ctx);
+    if (fb) {
+        fb_fill_convex(fb, SECOND_HAND[g_local_time.tm_sec], 4, GColorWhite);
+        graphics_release_frame_buffer(ctx, fb);
+    }
+}
+
+static void render_battery(GContext* ctx, GRect rect, void* data) {
+    int x = rect.origin.x;
+    int y = rect.origin.y;
+    int BAT_W = rect.size.w;
+    int BAT_H = rect.size.h-2;
     graphics_context_set_stroke_color(ctx, GColorWhite);
-    graphics_draw_rect(ctx, GRect(0, 2, BAT_W, BAT_H));
-    graphics_draw_rect(ctx, GRect(BAT_W/2-2, 0, 4, 2));
+    graphics_draw_rect(ctx, GRect(x, y+2, BAT_W, BAT_H));
+    graphics_draw_rect(ctx, GRect(x+BAT_W/2-2, y, 4, 2));
     graphics_context_set_stroke_color(ctx, GColorBlack);
-    graphics_draw_rect(ctx, GRect(BAT_W/2-1, 1, 2, 2));
+    graphics_draw_rect(ctx, GRect(x+BAT_W/2-1, y+1, 2, 2));
     graphics_context_set_fill_color(ctx, GColorWhite);
-    graphics_fill_rect(ctx, GRect(2, 4+(BAT_H-4)*(100-g_battery_level)/100, BAT_W-4, (BAT_H-4)*g_battery_level/100), 0, GCornerNone);
-    graphics_fill_rect(ctx, GRect(2, BAT_H-1, BAT_W-4, 1), 0, GCornerNone); // XXX Due to rounding errors.
+    graphics_fill_rect(ctx, GRect(x+2, y+4+(BAT_H-4)*(100-g_battery_level)/100, BAT_W-4, (BAT_H-4)*g_battery_level/100), 0, GCornerNone);
+    graphics_fill_rect(ctx, GRect(x+2, y+BAT_H-1, BAT_W-4, 1), 0, GCornerNone); // XXX Due to rounding errors.
     if (g_battery_level<=5) {
         graphics_context_set_fill_color(ctx, GColorDarkGray);
-        graphics_fill_rect(ctx, GRect(2, BAT_H-1, BAT_W-4, 1), 0, GCornerNone);
+        graphics_fill_rect(ctx, GRect(x+2, y+BAT_H-1, BAT_W-4, 1), 0, GCornerNone);
     }
 }
 
-static void on_connection_layer_update(Layer* layer, GContext* ctx) {
+static void render_connection(GContext* ctx, GRect rect, void* data) {
+    int x = rect.origin.x;
+    int y = rect.origin.y;
     graphics_context_set_stroke_color(ctx, GColorWhite);
     if (g_connected != 0) {
-        graphics_draw_line(ctx, GPoint(3, 0), GPoint(3, 12));
-        graphics_draw_line(ctx, GPoint(3, 0), GPoint(6, 3));
-        graphics_draw_line(ctx, GPoint(3, 12), GPoint(6, 9));
-    }
-    graphics_draw_line(ctx, GPoint(0, 3), GPoint(6, 9));
-    graphics_draw_line(ctx, GPoint(0, 9), GPoint(6, 3));
-}
-
-static void on_health_bpm_graph_layer_update(Layer* layer, GContext* ctx) {
-    HealthMinuteData minute_data[60];
-    time_t t2 = time(NULL);
-    time_t t1 = t2 - SECONDS_PER_HOUR;
-    // TODO Why not health_service_get_minute_history(minute_data, sizeof(minute_data), &t1, &t2));
-    health_service_get_minute_history(&minute_data[0], 60, &t1, &t2);
-    graphics_context_set_fill_color(ctx, GColorDarkGray);
-    graphics_fill_rect(ctx, GRect(1, 11, 33, 1), 0, GCornerNone);
-    graphics_context_set_stroke_color(ctx, GColorWhite);
+        graphics_draw_line(ctx, GPoint(x+3, y), GPoint(x+3, y+12));
+        graphics_draw_line(ctx, GPoint(x+3, y), GPoint(x+6, y+3));
+        graphics_draw_line(ctx, GPoint(x+3, y+12), GPoint(x+6, y+9));
+    }
+    graphics_draw_line(ctx, GPoint(x, y+3), GPoint(x+6, y+9));
+    graphics_draw_line(ctx, GPoint(x, y+9), GPoint(x+6, y+3));
+}
+
+// A line of text on a black background, like a TextLayer.
+typedef struct {
+    TextSlot slot;
+    GTextAlignment alignment;
+} WidgetText;
+
+static void render_text(GContext* ctx, GRect rect, void* data) {
+    const WidgetText* text = data;
+    graphics_context_set_fill_color(ctx, GColorBlack);
+    graphics_fill_rect(ctx, rect, 0, GCornerNone);
+    graphics_draw_text(ctx, text->slot.text, g_font, rect, GTextOverflowModeWordWrap, text->alignment, NULL);
+}
+
+// Bar heights of the heart rate graph for the last 30 minutes. The 30 minutes before them are only used to
+// find a good first datapoint.
+static void bpm_graph_heights(uint8_t heights[BPM_GRAPH_COLUMNS]) {
+    int32_t end_minute = g_bpm_history_end / SECONDS_PER_MINUTE;
     int last_y = 20;
-    for (int i=0; i<60; i++) {
-        int y;
-        if (minute_data[i].is_invalid || minute_data[i].heart_rate_bpm == 0) {
-            y = last_y;
+    for (int i=0; i<BPM_HISTORY_MINUTES; i++) {
+        uint8_t bpm = g_bpm_history[(end_minute - BPM_HISTORY_MINUTES + i) % BPM_HISTORY_MINUTES];
+        if (bpm != 0) {
+            last_y = min(20, max(1, 20-(bpm-50)*20/100));
+        }
+        if (i >= BPM_HISTORY_MINUTES-BPM_GRAPH_COLUMNS) {
+            heights[i-(BPM_HISTORY_MINUTES-BPM_GRAPH_COLUMNS)] = 21 - last_y;
+        }
+    }
+}
+
+static void render_bpm_graph(GContext* ctx, GRect rect, void* data) {
+    uint8_t heights[BPM_GRAPH_COLUMNS];
+    bpm_graph_heights(heights);
+    Sparkline spark = {
+        .frame = rect,
+        .heights = heights,
+        .count = BPM_GRAPH_COLUMNS,
+        .bar_x = 2,
+        .grid_row = 11,
+        .grid_columns = {16},
+    };
+    sparkline_draw(ctx, &spark);
+}
+
+static void render_weather_temp(GContext* ctx, GRect rect, void* data) {
+    int x = rect.origin.x;
+    int y = rect.origin.y;
+    const char* temp = g_temp_texts[0].text;
+    const char* tempmax = g_temp_texts[1].text;
+    const char* tempmin = g_temp_texts[2].text;
+    graphics_draw_text(ctx, temp, g_font,
+                       GRect(x,y+7,20,15), GTextOverflowModeWordWrap, GTextAlignmentRight, NULL);
+    graphics_draw_text(ctx, tempmax, g_font,
+                       GRect(x+20-((tempmax[0]=='-')?5:0),y,20,15), GTextOverflowModeWordWrap, GTextAlignmentLeft, NULL);
+    graphics_draw_text(ctx, tempmin, g_font,
+                       GRect(x+20-((tempmin[0]=='-')?5:0),y+14,20,15), GTextOverflowModeWordWrap, GTextAlignmentLeft, NULL);
+}
+
+static void render_weather_icon(GContext* ctx, GRect rect, void* data) {
+    if (g_weather_icon && g_weather_icon <= WEATHER_ICON_COUNT) {
+        if (!g_weather_icons_atlas) {
+            g_weather_icons_atlas = gbitmap_create_with_resource(RESOURCE_ID_WEATHER_ICONS_25);
+        }
+        if (g_weather_icon != g_weather_icon_view_key && g_weather_icons_atlas) {
+            if (g_weather_icon_view) {
+                gbitmap_destroy(g_weather_icon_view);
+            }
+            g_weather_icon_view = gbitmap_create_as_sub_bitmap(g_weather_icons_atlas, GRect(0, (g_weather_icon-1)*25, 25, 25));
+            g_weather_icon_view_key = g_weather_icon;
+        }
+        if (g_weather_icon_view) {
+            graphics_context_set_compositing_mode(ctx, GCompOpSet);
+            graphics_draw_bitmap_in_rect(ctx, g_weather_icon_view, GRect(rect.origin.x,rect.origin.y,25,25));
+        }
+    }
+}
+
+static void render_weather_precipprob(GContext* ctx, GRect rect, void* data) {
+    int x = rect.origin.x;
+    int y = rect.origin.y;
+    if (g_precipprob_text.text[0]) {
+        graphics_draw_text(ctx, g_precipprob_text.text, g_font,
+                           GRect(x,y+2,20,15), GTextOverflowModeWordWrap, GTextAlignmentRight, NULL);
+        graphics_draw_text(ctx, "%", g_font,
+                           GRect(x,y+13,20,15), GTextOverflowModeWordWrap, GTextAlignmentRight, NULL);
+    }
+}
+
+// The hourly forecast, two columns per hour starting with the current one, with guides 6 and 12 hours ahead.
+static void render_weather_forecast(GContext* ctx, GRect rect) {
+    time_t now = time(NULL);
+    time_t hour = now - now % SECONDS_PER_HOUR;
+    int8_t temps[PRECIP_GRAPH_COLUMNS/2];
+    uint8_t precips[PRECIP_GRAPH_COLUMNS/2];
+    int hours = 0;
+    int8_t temp_min = INT8_MAX;
+    int8_t temp_max = INT8_MIN;
+    while (hours < PRECIP_GRAPH_COLUMNS/2 &&
+           weather_forecast_at(hour + hours*SECONDS_PER_HOUR, &temps[hours], &precips[hours])) {
+        temp_min = min(temp_min, temps[hours]);
+        temp_max = max(temp_max, temps[hours]);
+        hours++;
+    }
+    uint8_t heights[PRECIP_GRAPH_COLUMNS];
+    for (int i = 0; i < 2*hours; i++) {
+        if (g_precip_view == PRECIP_VIEW_HOURLY_TEMP) {
+            heights[i] = 1 + (temps[i/2] - temp_min) * 22 / max(temp_max - temp_min, 1);
         } else {
-            y = min(20, max(1, 20-(minute_data[i].heart_rate_bpm-50)*20/100));
-            last_y = y;
-        }
-        if (i>=30) { // We are plotting the last 30 minutes, but reading the last 60 minutes is a cheap way ensure we are not starting with a bad datapoint.
-            graphics_draw_line(ctx, GPoint(i+2-30, y), GPoint(i+2-30, 20));
-        }
-    }
-    graphics_draw_rect(ctx, GRect(0,0,34,22));
-    graphics_fill_rect(ctx, GRect(16, 1, 1, 20), 0, GCornerNone);
-}
-
-static void on_weather_temp_layer_update(Layer* layer, GContext* ctx) {
-    char temp_string[4];
-    if (g_temp < 101 && g_tempmax < 101 && g_tempmin < 101) {
-        snprintf(temp_string, sizeof temp_string, "%d", g_temp);
-        graphics_draw_text(ctx, temp_string,
-                           fonts_get_system_font(FONT_KEY_GOTHIC_14),
-                           GRect(0,7,20,15), GTextOverflowModeWordWrap, GTextAlignmentRight, NULL);
-        snprintf(temp_string, sizeof temp_string, "%d", g_tempmax);
-        graphics_draw_text(ctx, temp_string,
-                           fonts_get_system_font(FONT_KEY_GOTHIC_14),
-                           GRect(20-((g_tempmax<0)?5:0),0,20,15), GTextOverflowModeWordWrap, GTextAlignmentLeft, NULL);
-        snprintf(temp_string, sizeof temp_string, "%d", g_tempmin);
-        graphics_draw_text(ctx, temp_string,
-                           fonts_get_system_font(FONT_KEY_GOTHIC_14),
-                           GRect(20-((g_tempmin<0)?5:0),14,20,15), GTextOverflowModeWordWrap, GTextAlignmentLeft, NULL);
-    }
-}
-
-static void on_weather_icon_layer_update(Layer* layer, GContext* ctx) {
-    static GBitmap *s_bitmap;
-    if (s_bitmap) {
-      gbitmap_destroy(s_bitmap);
-    }
-    uint32_t resource_id = 0;
-    if (g_weather_icon) {
-        switch (g_weather_icon) { // TODO Mark in readme https://icons8.com/ as icons' source!
-            case  1: resource_id = RESOURCE_ID_Sun_25; break;
-            case  2: resource_id = RESOURCE_ID_Bright_Moon_25; break;
-            case  3: resource_id = RESOURCE_ID_Rain_25; break;
-            case  4: resource_id = RESOURCE_ID_Snow_25; break;
-            case  5: resource_id = RESOURCE_ID_Sleet_25; break;
-            case  6: resource_id = RESOURCE_ID_Air_Element_25; break;
-            case  7: resource_id = RESOURCE_ID_Dust_25; break;
-            case  8: resource_id = RESOURCE_ID_Clouds_25; break;
-            case  9: resource_id = RESOURCE_ID_Partly_Cloudy_Day_25; break;
-            case 10: resource_id = RESOURCE_ID_Partly_Cloudy_Night_25; break;
-        }
-        s_bitmap  = gbitmap_create_with_resource(resource_id);
-        graphics_context_set_compositing_mode(ctx, GCompOpSet);
-        graphics_draw_bitmap_in_rect(ctx, s_bitmap, GRect(0,0,25,25));
-    }
-}
-
-static void on_weather_precipprob_layer_update(Layer* layer, GContext* ctx) {
-    char percent_string[4];
-    if (g_precipprob > 0) {
-        snprintf(percent_string, sizeof percent_string, "%d", g_precipprob);
-        graphics_draw_text(ctx, percent_string,
-                           fonts_get_system_font(FONT_KEY_GOTHIC_14),
-                           GRect(0,2,20,15), GTextOverflowModeWordWrap, GTextAlignmentRight, NULL);
-        graphics_draw_text(ctx, "%",
-                           fonts_get_system_font(FONT_KEY_GOTHIC_14),
-                           GRect(0,13,20,15), GTextOverflowModeWordWrap, GTextAlignmentRight, NULL);
+            heights[i] = precips[i/2] * 8 / 5;
+        }
     }
+    Sparkline spark = {
+        .frame = rect,
+        .heights = heights,
+        .count = 2*hours,
+        .bar_x = 2,
+        .grid_row = -1,
+        .grid_columns = {14, 26},
+        .shade = hours < PRECIP_GRAPH_COLUMNS/2 ? GRect(2*hours+2, 23, 46-2*hours, 2) : GRectZero, // Past the end of the forecast.
+    };
+    sparkline_draw(ctx, &spark);
 }
 
-static void on_weather_precipgraph_layer_update(Layer* layer, GContext* ctx) {
-    graphics_context_set_stroke_color(ctx, GColorWhite);
+static void render_weather_precipgraph(GContext* ctx, GRect rect, void* data) {
+    if (g_precip_view != PRECIP_VIEW_MINUTELY) {
+        render_weather_forecast(ctx, rect);
+        return;
+    }
+    int offset = weather_precip_offset();
+    int columns = min(PRECIP_GRAPH_COLUMNS, (int)sizeof g_weather_precip_array - offset);
+    uint8_t heights[PRECIP_GRAPH_COLUMNS];
     int count = 0;
-    int i;
-    for (i=0; i<45; i++) {
-        int i_off = g_ticks_since_weather_array_update+i;      
-        if (i_off < 60) {
-            if (g_weather_precip_array[i_off] > 0) {
-                count += 1;
-                graphics_draw_line(ctx, GPoint(i+2, 25-g_weather_precip_array[i_off]/10), GPoint(i+2, 25));
+    for (int i=0; i<columns; i++) {
+        uint8_t precip = g_weather_precip_array[offset+i];
+        heights[i] = precip > 0 ? precip/10 + 1 : 0;
+        count += precip > 0;
+    }
+    if (count == 0) {
+        return;
+    }
+    Sparkline spark = {
+        .frame = rect,
+        .heights = heights,
+        .count = columns,
+        .bar_x = 2,
+        .grid_row = -1,
+        .grid_columns = {17, 32},
+        .shade = offset>15 ? GRect(columns+1, 23, 46-columns, 2) : GRectZero, // Past the end of the forecast.
+    };
+    sparkline_draw(ctx, &spark);
+}
+
+// --------------------------------------------------------------------------
+// Widgets.
+// --------------------------------------------------------------------------
+
+// Everything on the screen is drawn by the update proc of a single layer, from this table. The window has
+// a clear background, so the frame buffer keeps the last frame and only dirty widgets are drawn again:
+// their rects are first reset to the bare dial, then they are drawn in table order.
+//
+// A reset also wipes whatever else overlapped the rect, and a widget drawn again paints over the widgets
+// above it, so those are drawn again as well - over their old selves, without a reset of their own. Every
+// widget draws the same over itself as over the bare dial, so that costs a redraw but no flicker, and
+// dirtiness does not spread to the whole screen. Widgets that blend into what is under them are the
+// exception: they are reset whenever they are drawn, like dirty ones.
+typedef void (*WidgetRender)(GContext* ctx, GRect rect, void* data);
+
+typedef struct {
+    GRect rect;
+    WidgetRender render;
+    bool dirty;
+    bool resting;  // Shown on the resting face too.
+    bool blends;   // Not idempotent, so never drawn over itself.
+    void* data;
+} Widget;
+
+static WidgetText g_bpm_text = {.alignment = GTextAlignmentLeft};
+static WidgetText g_health_meters_text = {.alignment = GTextAlignmentLeft};
+static WidgetText g_health_sleep_text = {.alignment = GTextAlignmentLeft};
+static WidgetText g_health_cals_text = {.alignment = GTextAlignmentLeft};
+static WidgetText g_my_message_text = {{"This is not normal!"}, GTextAlignmentRight};
+
+static Widget g_widgets[WIDGET_COUNT] = {
+    [WIDGET_HANDS] = {.render = render_hands, .resting = true}, // The rect follows the hands, see `hands_rect`.
+    [WIDGET_SECONDS] = {.render = render_seconds}, // Empty outside of the seconds mode.
+    [WIDGET_BATTERY] = {.rect = LAYOUT_BATTERY, .render = render_battery, .resting = true},
+    [WIDGET_CONNECTION] = {.rect = LAYOUT_CONNECTION, .render = render_connection},
+    [WIDGET_BPM_GRAPH] = {.rect = LAYOUT_HEALTH_BPM_GRAPH, .render = render_bpm_graph},
+    [WIDGET_BPM_TEXT] = {.rect = LAYOUT_HEALTH_BPM_TEXT, .render = render_text, .data = &g_bpm_text},
+    [WIDGET_HEALTH_METERS] = {.rect = LAYOUT_HEALTH_METERS, .render = render_text, .data = &g_health_meters_text},
+    [WIDGET_HEALTH_SLEEP] = {.rect = LAYOUT_HEALTH_SLEEP, .render = render_text, .data = &g_health_sleep_text},
+    [WIDGET_HEALTH_CALS] = {.rect = LAYOUT_HEALTH_CALS, .render = render_text, .data = &g_health_cals_text},
+    [WIDGET_WEATHER_TEMP] = {.rect = LAYOUT_WEATHER_TEMP, .render = render_weather_temp},
+    [WIDGET_WEATHER_ICON] = {.rect = LAYOUT_WEATHER_ICON, .render = render_weather_icon, .blends = true},
+    [WIDGET_WEATHER_PRECIPPROB] = {.rect = LAYOUT_WEATHER_PRECIPPROB, .render = render_weather_precipprob},
+    [WIDGET_WEATHER_PRECIPGRAPH] = {.rect = LAYOUT_WEATHER_PRECIPGRAPH, .render = render_weather_precipgraph},
+    [WIDGET_MY_MESSAGE] = {.rect = LAYOUT_MY_MESSAGE, .render = render_text, .data = &g_my_message_text},
+};
+
+static GRect g_damage; // Screen area to reset that no dirty widget covers, e.g. where a widget was before it moved.
+
+static void widget_mark_dirty(WidgetId id) {
+    g_widgets[id].dirty = true;
+    if (!g_resting || g_widgets[id].resting) { // Hidden widgets wait for the full face.
+        layer_mark_dirty(g_layer);
+    }
+}
+
+static void widget_move(WidgetId id, GRect rect) {
+    g_damage = rect_union(g_damage, g_widgets[id].rect);
+    g_widgets[id].rect = rect;
+    widget_mark_dirty(id);
+}
+
+static void widget_set_text(WidgetId id, const char* text) {
+    if (!text_slot_set(&((WidgetText*)g_widgets[id].data)->slot, text)) {
+        g_skipped_redraws += 1;
+        return;
+    }
+    widget_mark_dirty(id);
+}
+
+static void widgets_mark_all_dirty() {
+    for (int i = 0; i < WIDGET_COUNT; i++) {
+        g_widgets[i].dirty = true;
+    }
+    g_damage = layer_get_bounds(g_layer);
+    layer_mark_dirty(g_layer);
+}
+
+static void on_layer_update(Layer* layer, GContext* ctx) {
+    uint32_t start = now_ms();
+    GRect bounds = layer_get_bounds(layer);
+
+    // The first frame, and any frame without a dial cache, starts from scratch.
+    bool from_scratch = !g_dial_bitmap || g_dial_size.w != bounds.size.w || g_dial_size.h != bounds.size.h;
+    if (from_scratch) {
+        graphics_context_set_fill_color(ctx, GColorBlack);
+        graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+        FContext fctx;
+        fctx_init_context(&fctx, ctx);
+        fctx_set_color_bias(&fctx, 0);
+        draw_dial(&fctx);
+        fctx_deinit_context(&fctx);
+        dial_cache_store(ctx, bounds.size);
+        for (int i = 0; i < WIDGET_COUNT; i++) {
+            g_widgets[i].dirty = true;
+        }
+    }
+
+    // Leaving the resting face marks everything dirty, so hidden widgets can forget their changes.
+    for (int i = 0; i < WIDGET_COUNT && g_resting; i++) {
+        g_widgets[i].dirty &= g_widgets[i].resting;
+    }
+
+    // Dirty widgets, and the ones their resets or redraws reach - see the comment above the table. A
+    // blending widget drawn only because of an overlap is reset too, which can reach widgets below it, so
+    // this repeats until nothing more is drawn.
+    bool drawn[WIDGET_COUNT] = {false};
+    bool reset[WIDGET_COUNT] = {false};
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (int i = 0; i < WIDGET_COUNT; i++) {
+            GRect rect = g_widgets[i].rect;
+            if (drawn[i] || (g_resting && !g_widgets[i].resting)) {
+                continue;
             }
-        } else {
+            drawn[i] = g_widgets[i].dirty || rect_overlaps(rect, g_damage);
+            for (int j = 0; j < WIDGET_COUNT && !drawn[i]; j++) {
+                drawn[i] = rect_overlaps(rect, g_widgets[j].rect) && (reset[j] || (j < i && drawn[j]));
+            }
+            reset[i] = g_widgets[i].dirty || (drawn[i] && g_widgets[i].blends);
+            changed |= drawn[i];
+        }
+    }
+
+    if (!from_scratch) {
+        dial_cache_restore(ctx, g_damage);
+        for (int i = 0; i < WIDGET_COUNT; i++) {
+            if (reset[i]) {
+                dial_cache_restore(ctx, g_widgets[i].rect);
+            }
+        }
+    }
+    graphics_context_set_text_color(ctx, GColorWhite);
+    for (int i = 0; i < WIDGET_COUNT; i++) {
+        Widget* widget = &g_widgets[i];
+        if (drawn[i]) {
+            STATS_DRAW_BEGIN();
+            widget->render(ctx, widget->rect, widget->data);
+            STATS_DRAW_END(i);
+        }
+        widget->dirty = false;
+    }
+    g_damage = GRectZero;
+
+    uint32_t elapsed = now_ms() - start;
+    if (g_seconds_mode_until && elapsed > SECONDS_FRAME_BUDGET_MS) {
+        g_seconds_slow_frames += 1;
+    }
+    STATS_COUNT(frames);
+    STATS_ADD(frame_ms, elapsed);
+}
+
+static void on_window_appear(Window* window) {
+    // Whatever was shown over the watchface left its marks in the frame buffer.
+    widgets_mark_all_dirty();
+}
+
+// --------------------------------------------------------------------------
+// Redraw invalidation.
+// --------------------------------------------------------------------------
+
+// FNV-1a style mixing - cheap, and good enough to tell "same inputs" from "different inputs".
+#define FINGERPRINT_SEED 2166136261u
+
+static inline uint32_t fingerprint_mix(uint32_t fingerprint, uint32_t value) {
+    return (fingerprint ^ value) * 16777619u;
+}
+
+// The resting face changes only every `RESTING_REDRAW_MINUTES`.
+static uint32_t fingerprint_hands() {
+    uint32_t fp = FINGERPRINT_SEED;
+    fp = fingerprint_mix(fp, g_resting);
+    fp = fingerprint_mix(fp, g_resting ? g_local_time.tm_min / RESTING_REDRAW_MINUTES : g_local_time.tm_min);
+    fp = fingerprint_mix(fp, g_local_time.tm_hour);
+    fp = fingerprint_mix(fp, g_local_time.tm_mday);
+    fp = fingerprint_mix(fp, g_local_time.tm_mon);
+    return fp;
+}
+
+static uint32_t fingerprint_bpm_graph() {
+    uint8_t heights[BPM_GRAPH_COLUMNS];
+    bpm_graph_heights(heights);
+    uint32_t fp = FINGERPRINT_SEED;
+    for (int i=0; i<BPM_GRAPH_COLUMNS; i++) {
+        fp = fingerprint_mix(fp, heights[i]);
+    }
+    return fp;
+}
+
+// An empty graph draws nothing, so as long as it stays empty its fingerprint does not depend on the time.
+static uint32_t fingerprint_weather_precipgraph() {
+    if (g_precip_view != PRECIP_VIEW_MINUTELY) {
+        uint32_t fp = FINGERPRINT_SEED;
+        fp = fingerprint_mix(fp, g_precip_view);
+        fp = fingerprint_mix(fp, time(NULL) / SECONDS_PER_HOUR);
+        fp = fingerprint_mix(fp, g_forecast_revision);
+        return fp;
+    }
+    int offset = weather_precip_offset();
+    bool empty = true;
+    for (int i = offset; i < 60 && i < offset+45; i++) {
+        if (g_weather_precip_array[i] > 0) {
+            empty = false;
             break;
         }
     }
-    if (count > 0) {
-        graphics_draw_rect(ctx, GRect(0,0,49,27));
-        graphics_context_set_fill_color(ctx, GColorDarkGray);
-        graphics_fill_rect(ctx, GRect(17, 1, 1, 25), 0, GCornerNone);
-        graphics_fill_rect(ctx, GRect(32, 1, 1, 25), 0, GCornerNone);
-        if (g_ticks_since_weather_array_update>15) {
-            graphics_fill_rect(ctx, GRect(i+1, 23, 46-i, 2), 0, GCornerNone);
+    if (empty) {
+        return FINGERPRINT_SEED;
+    }
+    uint32_t fp = FINGERPRINT_SEED;
+    fp = fingerprint_mix(fp, offset);
+    fp = fingerprint_mix(fp, g_weather_precip_revision);
+    return fp;
+}
+
+static bool mark_dirty_if_changed(WidgetId id, uint32_t fingerprint) {
+    if (g_fingerprints[id] == fingerprint) {
+        g_skipped_redraws += 1;
+        return false;
+    }
+    g_fingerprints[id] = fingerprint;
+    widget_mark_dirty(id);
+    return true;
+}
+
+// Format the time and date. They change exactly when the hands' fingerprint does.
+static void time_texts_update() {
+    char text[TEXT_SLOT_SIZE];
+    append_time(text, text + sizeof text, &g_local_time);
+    text_slot_set(&g_time_text, text);
+    append_date(text, text + sizeof text, &g_local_time);
+    text_slot_set(&g_date_text, text);
+}
+
+// Format the weather numbers and mark the widgets whose texts changed.
+static void weather_texts_update() {
+    char text[TEXT_SLOT_SIZE];
+    const int8_t temps[3] = {g_temp, g_tempmax, g_tempmin};
+    bool known = g_temp < 101 && g_tempmax < 101 && g_tempmin < 101;
+    bool changed = false;
+    for (int i = 0; i < 3; i++) {
+        text[0] = '\0';
+        if (known) {
+            append_int(text, text + sizeof text, temps[i], 1);
         }
+        changed |= text_slot_set(&g_temp_texts[i], text);
+    }
+    if (changed) {
+        widget_mark_dirty(WIDGET_WEATHER_TEMP);
+    } else {
+        g_skipped_redraws += 1;
+    }
+    text[0] = '\0';
+    if (g_precipprob > 0) {
+        append_int(text, text + sizeof text, g_precipprob, 1);
+    }
+    if (text_slot_set(&g_precipprob_text, text)) {
+        widget_mark_dirty(WIDGET_WEATHER_PRECIPPROB);
+    } else {
+        g_skipped_redraws += 1;
+    }
+}
+
+// --------------------------------------------------------------------------
+// Messages to the phone.
+// --------------------------------------------------------------------------
+
+static bool send_to_phone(uint32_t key, uint8_t value) {
+    DictionaryIterator* iter;
+    if (app_message_outbox_begin(&iter) != APP_MSG_OK) {
+        return false;
+    }
+    dict_write_uint8(iter, key, value);
+    STATS_COUNT(messages_sent);
+    STATS_ADD(bytes_sent, dict_size(iter));
+    return app_message_outbox_send() == APP_MSG_OK;
+}
+
+// The phone polls on its own schedule; this only covers data that went stale while it could not reach us.
+static void weather_request_if_stale() {
+    time_t now = time(NULL);
+    if (!g_connected || now - g_weather_received < WEATHER_STALE_AGE || now - g_weather_requested < WEATHER_REQUEST_INTERVAL) {
+        return;
+    }
+    if (send_to_phone(WEATHER_REQUEST_KEY, g_battery_level)) {
+        g_weather_requested = now;
+    }
+}
+
+// --------------------------------------------------------------------------
+// Health snapshot.
+// --------------------------------------------------------------------------
+
+// Read all of today's health sums in one pass and update only the texts whose values changed.
+static void health_snapshot_update() {
+    char text[TEXT_SLOT_SIZE];
+    char* end = text + sizeof text;
+    HealthSnapshot snapshot = {
+        .resting_kcal = health_service_sum_today(HealthMetricRestingKCalories),
+        .active_kcal = health_service_sum_today(HealthMetricActiveKCalories),
+        .walked_meters = health_service_sum_today(HealthMetricWalkedDistanceMeters),
+        .sleep = health_service_sum_today(HealthMetricSleepSeconds),
+        .restful = health_service_sum_today(HealthMetricSleepRestfulSeconds),
+    };
+    STATS_ADD(health_calls, 5);
+    if (snapshot.resting_kcal != g_health.resting_kcal || snapshot.active_kcal != g_health.active_kcal) {
+        char* p = append_int(text, end, snapshot.resting_kcal+snapshot.active_kcal, 1);
+        p = append_text(p, end, "Cal(");
+        p = append_int(p, end, snapshot.active_kcal, 1);
+        append_text(p, end, ")");
+        widget_set_text(WIDGET_HEALTH_CALS, text);
+    }
+    if (snapshot.walked_meters != g_health.walked_meters) {
+        char* p = append_decimal(text, end, snapshot.walked_meters, 1000);
+        append_text(p, end, "km");
+        widget_set_text(WIDGET_HEALTH_METERS, text);
+    }
+    if (snapshot.sleep != g_health.sleep || snapshot.restful != g_health.restful) {
+        int restful_percent = snapshot.sleep > 0 ? snapshot.restful*100/snapshot.sleep : 0;
+        char* p = append_int(text, end, restful_percent, 1);
+        p = append_text(p, end, "%/");
+        p = append_decimal(p, end, snapshot.sleep, SECONDS_PER_HOUR);
+        append_text(p, end, "h");
+        widget_set_text(WIDGET_HEALTH_SLEEP, text);
+    }
+    g_health = snapshot;
+}
+
+static void health_bpm_update() {
+    int32_t bpm = health_service_peek_current_value(HealthMetricHeartRateBPM);
+    STATS_COUNT(health_calls);
+    if (bpm != g_health_bpm) {
+        char text[TEXT_SLOT_SIZE];
+        char* p = append_text(text, text + sizeof text, "\U00002764");
+        append_int(p, text + sizeof text, bpm, 1);
+        widget_set_text(WIDGET_BPM_TEXT, text);
+        g_health_bpm = bpm;
     }
 }
 
+// --------------------------------------------------------------------------
+// Resting face.
+// --------------------------------------------------------------------------
+
+// Nobody reads the graphs, the weather or the minute hand while asleep or with the watch on the nightstand.
+// The resting face shows just the dial, the hour hand and the battery, and until a tap or some activity
+// brings the full face back the heart rate history, the health sums and the weather requests are paused.
+
+static bool resting_asleep() {
+    STATS_COUNT(health_calls);
+    return health_service_peek_current_activities() & (HealthActivitySleep | HealthActivityRestfulSleep);
+}
+
+// Needs an up to date heart rate history.
+static Resting resting_detect() {
+    if (resting_asleep()) {
+        return RESTING_ASLEEP;
+    }
+    if (!g_heart_rate_available) {
+        return RESTING_NONE;
+    }
+    time_t end = g_bpm_history_end / SECONDS_PER_MINUTE;
+    for (time_t minute = end - RESTING_OFF_WRIST_MINUTES; minute < end; minute++) {
+        if (g_bpm_history[minute % BPM_HISTORY_MINUTES] > 0) {
+            return RESTING_NONE;
+        }
+    }
+    return RESTING_OFF_WRIST;
+}
+
+// Everything the full face refreshes on a minute tick.
+static void minute_update() {
+    bpm_history_update();
+    if (mark_dirty_if_changed(WIDGET_HANDS, fingerprint_hands())) {
+        time_texts_update();
+        widget_move(WIDGET_HANDS, hands_rect());
+    }
+    mark_dirty_if_changed(WIDGET_BPM_GRAPH, fingerprint_bpm_graph());
+    mark_dirty_if_changed(WIDGET_WEATHER_PRECIPGRAPH, fingerprint_weather_precipgraph());
+    weather_request_if_stale();
+}
+
+static void resting_enter_if_idle() {
+    if (g_resting || g_seconds_mode_until || time(NULL) < g_resting_hold_until) {
+        return;
+    }
+    g_resting = resting_detect();
+    if (g_resting) {
+        mark_dirty_if_changed(WIDGET_HANDS, fingerprint_hands());
+        widget_move(WIDGET_HANDS, hands_rect());
+        widgets_mark_all_dirty();
+    }
+}
+
+static void resting_leave() {
+    if (!g_resting) {
+        return;
+    }
+    g_resting = RESTING_NONE;
+    g_resting_hold_until = max(g_resting_hold_until, time(NULL) + RESTING_HOLD);
+    widgets_mark_all_dirty();
+    minute_update();
+    health_bpm_update();
+    health_snapshot_update();
+}
+
 // --------------------------------------------------------------------------
 // System event handlers.
 // --------------------------------------------------------------------------
 
 static void on_tick_timer(struct tm* tick_time, TimeUnits units_changed) {
+    STATS_COUNT(ticks);
     g_local_time = *tick_time;
-    g_ticks_since_weather_array_update += 1;
-    layer_mark_dirty(g_layer);
-    layer_mark_dirty(g_health_bpm_graph_layer);
-    layer_mark_dirty(g_weather_precipgraph_layer);
+    if (g_seconds_mode_until) {
+        if (time(NULL) >= g_seconds_mode_until || g_seconds_slow_frames >= SECONDS_SLOW_FRAMES) {
+            g_seconds_mode_until = 0;
+            tick_timer_service_subscribe(MINUTE_UNIT, &on_tick_timer);
+            g_precip_view = PRECIP_VIEW_MINUTELY;
+            mark_dirty_if_changed(WIDGET_WEATHER_PRECIPGRAPH, fingerprint_weather_precipgraph());
+        }
+        widget_move(WIDGET_SECONDS, seconds_rect());
+    }
+    if (!(units_changed & MINUTE_UNIT)) {
+        return;
+    }
+    if (g_resting) { // Only the hour hand moves, in steps.
+        if (mark_dirty_if_changed(WIDGET_HANDS, fingerprint_hands())) {
+            widget_move(WIDGET_HANDS, hands_rect());
+        }
+        return;
+    }
+    minute_update();
+    resting_enter_if_idle();
 }
 
 static void on_battery_state(BatteryChargeState state) {
+    if (state.charge_percent / 10 != g_battery_level / 10) { // The phone polls less often on a low battery.
+        send_to_phone(WATCH_BATTERY_KEY, state.charge_percent);
+    }
     g_battery_level = state.charge_percent;
-    layer_mark_dirty(g_battery_layer);
+    widget_mark_dirty(WIDGET_BATTERY);
 }
 
 static void on_connection(bool connected) {
     g_connected = connected ? 1 : 0; // TODO weird data type conversion
-    layer_mark_dirty(g_connection_layer);
+    widget_mark_dirty(WIDGET_CONNECTION);
+    weather_request_if_stale();
+}
+
+static void on_health_timer(void* context) {
+    STATS_COUNT(timers);
+    g_health_timer = NULL;
+    if (g_resting) {
+        // Movement while not asleep is someone up and about. Leaving reads the health sums anyway.
+        if (!resting_asleep()) {
+            resting_leave();
+        }
+        return;
+    }
+    health_snapshot_update();
 }
 
 static void on_health(const HealthEventType event, void* context) {
-    static char Cal_string[13];
-    static char meter_string[7];
-    static char sleep_string[13];
-    static char bpm_string[8];
+    STATS_COUNT(health_events);
     switch (event) {
         case HealthEventHeartRateUpdate:
-            snprintf(bpm_string, sizeof bpm_string, "\U00002764%d", (int)health_service_peek_current_value(HealthMetricHeartRateBPM));
-            text_layer_set_text(g_health_bpm_text_layer, bpm_string);
+            health_bpm_update();
+            if (g_resting == RESTING_OFF_WRIST && g_health_bpm > 0) { // Worn again.
+                resting_leave();
+            }
             break;
         default:
-            snprintf(Cal_string, sizeof Cal_string, "%dCal(%d)", (int)(health_service_sum_today(HealthMetricRestingKCalories)+health_service_sum_today(HealthMetricActiveKCalories)), (int)health_service_sum_today(HealthMetricActiveKCalories)); 
-            text_layer_set_text(g_health_cals_text_layer, Cal_string);
-            int walked_meters = health_service_sum_today(HealthMetricWalkedDistanceMeters);
-            snprintf(meter_string, sizeof meter_string, "%d.%dkm", walked_meters/1000, (walked_meters%1000)/100);
-            text_layer_set_text(g_health_meters_text_layer, meter_string);
-            int32_t sleep = health_service_sum_today(HealthMetricSleepSeconds);
-            int32_t restful = health_service_sum_today(HealthMetricSleepRestfulSeconds);
-            snprintf(sleep_string, sizeof sleep_string, "%d%%/%d.%dh", (int)(restful*100/sleep), (int)(sleep/3600), (int)((sleep%3600)*10/3600)); 
-            text_layer_set_text(g_health_sleep_text_layer, sleep_string);
+            // The first event of a burst opens the window, the rest of the burst is absorbed by it.
+            if (!g_health_timer) {
+                g_health_timer = app_timer_register(HEALTH_COALESCE_MS, &on_health_timer, NULL);
+            }
             break;
     }
 }
 
+// A tap brings back the full face and shows the seconds hand for a while. Each further tap while the
+// seconds hand is up moves the precipitation graph to its next view.
 static void on_tap(AccelAxisType axis, int32_t direction) {
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "tap: %d %d", axis, direction);
+    STATS_COUNT(taps);
+    time_t now = time(NULL);
+    bool woken = g_resting;
+    g_resting_hold_until = now + RESTING_HOLD;
+    resting_leave();
+    bool start = !g_seconds_mode_until;
+    g_seconds_mode_until = now + SECONDS_MODE_DURATION; // Taps in the seconds mode prolong it.
+    if (start) {
+        g_seconds_slow_frames = 0;
+        g_local_time = *localtime(&now);
+        tick_timer_service_subscribe(SECOND_UNIT, &on_tick_timer);
+        widget_move(WIDGET_SECONDS, seconds_rect());
+    }
+    if (!start && !woken && g_forecast_start) {
+        g_precip_view = (g_precip_view + 1) % PRECIP_VIEW_COUNT;
+        mark_dirty_if_changed(WIDGET_WEATHER_PRECIPGRAPH, fingerprint_weather_precipgraph());
+    }
 }
 
-static void on_sync_error(DictionaryResult dict_error, AppMessageResult app_message_error, void *context) {
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "App Message Sync Error: %d", app_message_error);
+static void on_inbox_dropped(AppMessageResult reason, void *context) {
+    STATS_COUNT(dropped_messages);
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "App Message Dropped: %d", reason);
 }
 
-static void on_sync_tuple_change(const uint32_t key, const Tuple* new_tuple, const Tuple* old_tuple, void* context) {
-    switch (key) {
-        case WEATHER_ICON_KEY:
-            g_weather_icon = new_tuple->value->uint8;
-            layer_mark_dirty(g_weather_icon_layer);
-            break;
-        case WEATHER_TEMPERATURE_KEY:
-            g_temp = new_tuple->value->int8;
-            layer_mark_dirty(g_weather_temp_layer);
-            break;
-        case WEATHER_TEMPERATUREMAX_KEY:
-            g_tempmax = new_tuple->value->int8;
-            layer_mark_dirty(g_weather_temp_layer);
-            break;
-        case WEATHER_TEMPERATUREMIN_KEY:
-            g_tempmin = new_tuple->value->int8;
-            layer_mark_dirty(g_weather_temp_layer);
-            break;
-        case WEATHER_PRECIP_PROB_KEY:
-            g_precipprob = new_tuple->value->uint8;
-            layer_mark_dirty(g_weather_precipprob_layer);
-            break;
-        case WEATHER_PRECIP_ARRAY_KEY:
-            for (int i=0; i<new_tuple->length; i++) {g_weather_precip_array[i] = new_tuple->value->data[i];}
-            g_ticks_since_weather_array_update = 0;
-            layer_mark_dirty(g_weather_precipgraph_layer);
-            break;
-        default:
-            break;
+static void on_inbox_received(DictionaryIterator* iter, void* context) {
+    STATS_COUNT(messages);
+    STATS_ADD(bytes_received, dict_size(iter));
+    bool weather = false; // Whether any weather key was decoded.
+    bool battery_asked = false;
+#if STATS_ENABLED
+    bool stats_asked = false;
+#endif
+    for (Tuple* tuple = dict_read_first(iter); tuple; tuple = dict_read_next(iter)) {
+        int32_t value;
+        switch (tuple->key) {
+            case WEATHER_ICON_KEY:
+                if (tuple_read_int(tuple, &value)) {
+                    g_weather_icon = value;
+                    weather = true;
+                }
+                break;
+            case WEATHER_TEMPERATURE_KEY:
+                if (tuple_read_int(tuple, &value)) {
+                    g_temp = value;
+                    weather = true;
+                }
+                break;
+            case WEATHER_TEMPERATUREMAX_KEY:
+                if (tuple_read_int(tuple, &value)) {
+                    g_tempmax = value;
+                    weather = true;
+                }
+                break;
+            case WEATHER_TEMPERATUREMIN_KEY:
+                if (tuple_read_int(tuple, &value)) {
+                    g_tempmin = value;
+                    weather = true;
+                }
+                break;
+            case WEATHER_PRECIP_PROB_KEY:
+                if (tuple_read_int(tuple, &value)) {
+                    g_precipprob = value;
+                    weather = true;
+                }
+                break;
+            case WEATHER_PRECIP_ARRAY_KEY:
+                if (tuple->type != TUPLE_BYTE_ARRAY || !weather_precip_decode(tuple->value->data, tuple->length)) {
+                    APP_LOG(APP_LOG_LEVEL_WARNING, "Unknown precipitation encoding");
+                    break;
+                }
+                g_weather_time = time(NULL);
+                g_weather_precip_revision += 1;
+                weather = true;
+                break;
+            case WEATHER_HOURLY_KEY:
+                if (tuple->type != TUPLE_BYTE_ARRAY || !weather_hourly_decode(tuple->value->data, tuple->length)) {
+                    APP_LOG(APP_LOG_LEVEL_WARNING, "Unknown hourly forecast encoding");
+                    break;
+                }
+                g_forecast_revision += 1;
+                weather = true;
+                break;
+            case WATCH_BATTERY_KEY:
+                battery_asked = true;
+                break;
+#if STATS_ENABLED
+            case DEBUG_STATS_KEY:
+                stats_asked = true;
+                break;
+#endif
+            default:
+                break;
+        }
+    }
+    if (battery_asked) {
+        send_to_phone(WATCH_BATTERY_KEY, g_battery_level);
+    }
+#if STATS_ENABLED
+    if (stats_asked) {
+        stats_send();
     }
+#endif
+    // Other keys, e.g. a stats request on a build without stats, say nothing about the weather being current.
+    if (!weather) {
+        return;
+    }
+    mark_dirty_if_changed(WIDGET_WEATHER_ICON, fingerprint_mix(FINGERPRINT_SEED, g_weather_icon));
+    weather_texts_update();
+    mark_dirty_if_changed(WIDGET_WEATHER_PRECIPGRAPH, fingerprint_weather_precipgraph());
+    g_weather_received = time(NULL);
+    snapshot_save();
 }
 
 
@@ -410,129 +1737,77 @@ static void on_sync_tuple_change(const uint32_t key, const Tuple* new_tuple, con
 // --------------------------------------------------------------------------
 
 static void init() {
+    STATS_START();
+    snapshot_restore();
+
+    time_t now = time(NULL);
+    g_local_time = *localtime(&now);
+    g_widgets[WIDGET_HANDS].rect = hands_rect();
+    time_texts_update();
+
+    g_font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+    g_font_time = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
+    g_font_date = fonts_get_system_font(FONT_KEY_GOTHIC_14_BOLD);
+
     g_window = window_create();
-    window_stack_push(g_window, true);
-    window_set_background_color(g_window, GColorBlack);
+    window_set_background_color(g_window, GColorClear);
+    window_set_window_handlers(g_window, (WindowHandlers) {.appear = on_window_appear});
     Layer* window_layer = window_get_root_layer(g_window);
-    GRect window_frame = layer_get_frame(window_layer);
-
-    g_layer = layer_create(window_frame);
+    g_layer = layer_create(layer_get_frame(window_layer));
     layer_set_update_proc(g_layer, &on_layer_update);
     layer_add_child(window_layer, g_layer);
-    GRect bounds = layer_get_bounds(g_layer);
-
-    g_battery_layer = layer_create(GRect(1, bounds.size.h/2-16, 10, 17));
-    layer_set_update_proc(g_battery_layer, &on_battery_layer_update);
-    layer_add_child(window_layer, g_battery_layer);
-
-    g_connection_layer = layer_create(GRect(2, bounds.size.h/2+4, 7, 13));
-    layer_set_update_proc(g_connection_layer, &on_connection_layer_update);
-    layer_add_child(window_layer, g_connection_layer);
-
-    g_health_bpm_graph_layer = layer_create(GRect(1, 1, 34, 22));
-    layer_set_update_proc(g_health_bpm_graph_layer, &on_health_bpm_graph_layer_update);
-    layer_add_child(window_layer, g_health_bpm_graph_layer);
-
-    g_health_bpm_text_layer = text_layer_create(GRect(1, 24, bounds.size.w/4, 14));
-    layer_add_child(window_layer, text_layer_get_layer(g_health_bpm_text_layer));
-    text_layer_set_background_color(g_health_bpm_text_layer, GColorBlack);
-    text_layer_set_text_color(g_health_bpm_text_layer, GColorWhite);
-    text_layer_set_font(g_health_bpm_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-    
-    g_health_meters_text_layer = text_layer_create(GRect(1, bounds.size.h-43, bounds.size.w/4, 14));
-    layer_add_child(window_layer, text_layer_get_layer(g_health_meters_text_layer));
-    text_layer_set_background_color(g_health_meters_text_layer, GColorBlack);
-    text_layer_set_text_color(g_health_meters_text_layer, GColorWhite);
-    text_layer_set_font(g_health_meters_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-    
-    g_health_sleep_text_layer = text_layer_create(GRect(1, bounds.size.h-29, bounds.size.w*2/5-3, 14));
-    layer_add_child(window_layer, text_layer_get_layer(g_health_sleep_text_layer));
-    text_layer_set_background_color(g_health_sleep_text_layer, GColorBlack);
-    text_layer_set_text_color(g_health_sleep_text_layer, GColorWhite);
-    text_layer_set_overflow_mode(g_health_sleep_text_layer, GTextOverflowModeWordWrap);
-    text_layer_set_font(g_health_sleep_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-
-    g_health_cals_text_layer = text_layer_create(GRect(1, bounds.size.h-15, bounds.size.w/2, 14));
-    layer_add_child(window_layer, text_layer_get_layer(g_health_cals_text_layer));
-    text_layer_set_background_color(g_health_cals_text_layer, GColorBlack);
-    text_layer_set_text_color(g_health_cals_text_layer, GColorWhite);
-    text_layer_set_font(g_health_cals_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-
-    g_weather_temp_layer = layer_create(GRect(bounds.size.w-32, bounds.size.h/2, 32, 30));
-    layer_set_update_proc(g_weather_temp_layer, &on_weather_temp_layer_update);
-    layer_add_child(window_layer, g_weather_temp_layer);
-
-    g_weather_icon_layer = layer_create(GRect(bounds.size.w-29, bounds.size.h*21/30-1, 25, 25));
-    layer_set_update_proc(g_weather_icon_layer, &on_weather_icon_layer_update);
-    layer_add_child(window_layer, g_weather_icon_layer);
-
-    g_weather_precipprob_layer = layer_create(GRect(bounds.size.w-20, bounds.size.h-30, 20, 30));
-    layer_set_update_proc(g_weather_precipprob_layer, &on_weather_precipprob_layer_update);
-    layer_add_child(window_layer, g_weather_precipprob_layer);
-
-    g_weather_precipgraph_layer = layer_create(GRect(bounds.size.w/2+4, bounds.size.h-27, 49, 27));
-    layer_set_update_proc(g_weather_precipgraph_layer, &on_weather_precipgraph_layer_update);
-    layer_add_child(window_layer, g_weather_precipgraph_layer);
-
-    g_my_message_layer = text_layer_create(GRect(37, 0, bounds.size.w-37, 14));
-    layer_add_child(window_layer, text_layer_get_layer(g_my_message_layer));
-    text_layer_set_background_color(g_my_message_layer, GColorBlack);
-    text_layer_set_text_color(g_my_message_layer, GColorWhite);
-    text_layer_set_font(g_my_message_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-    text_layer_set_text_alignment(g_my_message_layer, GTextAlignmentRight);
-    text_layer_set_text(g_my_message_layer, "This is not normal!");
+    window_stack_push(g_window, true);
+    weather_texts_update();
   
-    time_t now = time(NULL);
-    g_local_time = *localtime(&now);
     tick_timer_service_subscribe(MINUTE_UNIT, &on_tick_timer);
+
+    // Open the app message channel first: the battery and connection handlers below may send right away.
+    app_message_register_inbox_received(on_inbox_received);
+    app_message_register_inbox_dropped(on_inbox_dropped);
+    app_message_open(MESSAGE_BUF, STATS_OUTBOX_BUF);
   
     battery_state_service_subscribe(&on_battery_state);
-    on_battery_state(battery_state_service_peek());
+    // Not sent: PebbleKit JS is not running yet and asks for the level once it is.
+    g_battery_level = battery_state_service_peek().charge_percent;
   
+    g_heart_rate_available = health_service_metric_accessible(HealthMetricHeartRateBPM, now - SECONDS_PER_DAY, now)
+                           & HealthServiceAccessibilityMaskAvailable;
+    bpm_history_update();
     health_service_events_subscribe(&on_health, NULL);
-    on_health(HealthEventHeartRateUpdate, NULL);
+    health_bpm_update();
+    health_snapshot_update();
+    resting_enter_if_idle();
 
     connection_service_subscribe((ConnectionHandlers) {.pebble_app_connection_handler = on_connection});
     on_connection(connection_service_peek_pebble_app_connection());
   
     accel_tap_service_subscribe(on_tap);  
-  
-    Tuplet initial_values[] = {
-        TupletInteger(WEATHER_ICON_KEY, (uint8_t)0),
-        TupletInteger(WEATHER_TEMPERATURE_KEY, (int8_t)101),
-        TupletInteger(WEATHER_TEMPERATUREMAX_KEY, (int8_t)101),
-        TupletInteger(WEATHER_TEMPERATUREMIN_KEY, (int8_t)101),
-        TupletInteger(WEATHER_PRECIP_PROB_KEY, (uint8_t)0),
-        TupletBytes(WEATHER_PRECIP_ARRAY_KEY, g_weather_precip_array, sizeof(g_weather_precip_array))
-    };
 
-    app_sync_init(&g_sync, g_sync_buffer, sizeof(g_sync_buffer),
-                  initial_values, ARRAY_LENGTH(initial_values),
-                  on_sync_tuple_change, on_sync_error, NULL);
-    app_message_open(MESSAGE_BUF, MESSAGE_BUF);
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Heap used: %d bytes", (int)heap_bytes_used());
 }
 
 static void deinit() {
+    snapshot_save();
     tick_timer_service_unsubscribe();
     battery_state_service_unsubscribe();
     health_service_events_unsubscribe();
+    if (g_health_timer) {
+        app_timer_cancel(g_health_timer);
+    }
     connection_service_unsubscribe();
     accel_tap_service_unsubscribe();
     layer_destroy(g_layer);
-    layer_destroy(g_battery_layer);
-    layer_destroy(g_connection_layer);
-    layer_destroy(g_health_bpm_graph_layer);
-    layer_destroy(g_weather_temp_layer);
-    layer_destroy(g_weather_icon_layer);
-    layer_destroy(g_weather_precipprob_layer);
-    layer_destroy(g_weather_precipgraph_layer);
-    text_layer_destroy(g_health_cals_text_layer);
-    text_layer_destroy(g_health_meters_text_layer);
-    text_layer_destroy(g_health_sleep_text_layer);
-    text_layer_destroy(g_health_bpm_text_layer);
-    text_layer_destroy(g_my_message_layer);
+    if (g_dial_bitmap) {
+        gbitmap_destroy(g_dial_bitmap);
+    }
+    if (g_weather_icon_view) {
+        gbitmap_destroy(g_weather_icon_view);
+    }
+    if (g_weather_icons_atlas) {
+        gbitmap_destroy(g_weather_icons_atlas);
+    }
     window_destroy(g_window);
-    app_sync_deinit(&g_sync);
+    app_message_deregister_callbacks();
 }
 
 // --------------------------------------------------------------------------
@@ -2,6 +2,7 @@ var DarkskyKey = localStorage.getItem("DarkskyKey");
 
 var Clay = require('pebble-clay');
 var clayConfig = require('./config');
+var weather = require('./weather');
 var clay = new Clay(clayConfig, null, { autoHandleEvents: false });
 
 Pebble.addEventListener('showConfiguration', function(e) {
@@ -13,6 +14,8 @@ Pebble.addEventListener('webviewclosed', function(e) {
   var json_resp = JSON.parse(e.response);
   DarkskyKey = json_resp.DarkskyKey.value;
   localStorage.setItem("DarkskyKey", DarkskyKey);
+  failures = 0;
+  schedulePoll(0);
 });
 
 var iconNameToId = {
@@ -28,37 +31,285 @@ var iconNameToId = {
   'partly-cloudy-night': 10
 };
 
+// Precipitation series encoding, version 1 - decoded by `weather_precip_decode` in watchface.c.
+// A version byte followed by one byte per run of equal samples:
+// high nibble - run length minus one (1 to 16 samples), low nibble - intensity level (0 to 15).
+var PRECIP_ENCODING_VERSION = 1;
+
+// cm/h scaled to 4 bits, >7.6 mm/h is the definition of heavy rain; any rain at all gets at least level 1
+function precipLevel(intensity) {
+  if (!(intensity > 0)) {return 0;}
+  return Math.max(1, Math.min(Math.round(intensity/10*15), 15));
+}
+
+function encodePrecip(levels) {
+  var bytes = [PRECIP_ENCODING_VERSION];
+  var i = 0;
+  while (i < levels.length) {
+    var run = 1;
+    while (run < 16 && i+run < levels.length && levels[i+run] === levels[i]) {run++;}
+    bytes.push(((run-1) << 4) | levels[i]);
+    i += run;
+  }
+  return bytes;
+}
+
+// Hourly forecast encoding, version 1 - decoded by `weather_hourly_decode` in watchface.c.
+// A version byte, the first hour as a little endian 32 bit unix time, 24 temperatures in whole degrees as
+// signed bytes (127 - unknown) and 24 precipitation probabilities scaled to 4 bits, two per byte with the
+// earlier hour in the low nibble.
+var HOURLY_ENCODING_VERSION = 1;
+var HOURLY_HOURS = 24;
+var HOURLY_TEMP_UNKNOWN = 127;
+
+function encodeHourly(hourly) {
+  var start = hourly.length ? hourly[0].time : 0;
+  var bytes = [HOURLY_ENCODING_VERSION, start & 0xff, (start >>> 8) & 0xff, (start >>> 16) & 0xff, (start >>> 24) & 0xff];
+  var probabilities = [];
+  for (var i = 0; i < HOURLY_HOURS; i++) {
+    var hour = hourly[i];
+    var temperature = hour && typeof hour.temperature === 'number' ? Math.max(-126, Math.min(Math.round(hour.temperature), 126)) : HOURLY_TEMP_UNKNOWN;
+    bytes.push(temperature & 0xff);
+    probabilities.push(hour ? Math.round((hour.precipProbability || 0)*15) : 0);
+  }
+  for (var j = 0; j < HOURLY_HOURS; j += 2) {
+    bytes.push(probabilities[j] | (probabilities[j+1] << 4));
+  }
+  return bytes;
+}
+
+// The watch's inbox holds MESSAGE_BUF (watchface.c) bytes - larger messages are split and queued.
+var MESSAGE_BUF = 128;
+
+// Size of a message as a Pebble dictionary: a count byte, then per tuple a 7 byte header and the value.
+function messageSize(message) {
+  var size = 1;
+  for (var key in message) {
+    size += 7 + (Array.isArray(message[key]) ? message[key].length : 4);
+  }
+  return size;
+}
+
+function splitMessage(message) {
+  var parts = [];
+  var part = {};
+  for (var key in message) {
+    part[key] = message[key];
+    if (messageSize(part) > MESSAGE_BUF && Object.keys(part).length > 1) {
+      delete part[key];
+      parts.push(part);
+      part = {};
+      part[key] = message[key];
+    }
+  }
+  parts.push(part);
+  return parts;
+}
+
+// Send the messages one after another; the watch takes one at a time.
+function sendQueued(messages, success, failure) {
+  if (!messages.length) {
+    success();
+    return;
+  }
+  Pebble.sendAppMessage(messages[0], function (){
+    sendQueued(messages.slice(1), success, failure);
+  }, failure);
+}
+
+// What the watch was last sent, so unchanged keys can be left out of the next message.
+var lastSent = {};
+
+function changedKeys(json) {
+  var message = {};
+  var empty = true;
+  for (var key in json) {
+    if (String(json[key]) !== String(lastSent[key])) {
+      message[key] = json[key];
+      empty = false;
+    }
+  }
+  return empty ? null : message;
+}
+
+// Polling schedule. The interval follows the weather - frequent while rain is coming, rare on dry days -
+// and stretches when the watch battery is low. Failures back off exponentially.
+var MINUTE = 60*1000;
+var POLL_INTERVAL = 10*MINUTE;
+var MIN_POLL_GAP = 2*MINUTE;    // Watch requests closer to the last fetch than this are ignored.
+var MAX_BACKOFF = 60*MINUTE;
+
+var pollTimer = null;
+var fetching = false;
+var failures = 0;
+var watchBattery = 100;
+
+function pollInterval(levels, precipProbability) {
+  var interval;
+  if (levels.some(function (l){return l > 0;})) {
+    interval = 5*MINUTE;            // Rain within the hour - keep the nowcast fresh.
+  } else if (precipProbability >= 0.3) {
+    interval = POLL_INTERVAL;
+  } else if (precipProbability >= 0.1) {
+    interval = 20*MINUTE;
+  } else {
+    interval = 30*MINUTE;
+  }
+  if (watchBattery <= 10) {
+    interval *= 4;
+  } else if (watchBattery <= 20) {
+    interval *= 2;
+  }
+  return interval;
+}
+
+function schedulePoll(delay) {
+  clearTimeout(pollTimer);
+  pollTimer = setTimeout(sendWeather, delay);
+}
+
+function pollFailed(reason) {
+  console.log("Weather update failed: " + reason);
+  fetching = false;
+  failures += 1;
+  schedulePoll(Math.min(MINUTE * Math.pow(2, failures-1), MAX_BACKOFF));
+}
+
 function sendWeather() {
-    if (DarkskyKey!==null) {
-        navigator.geolocation.getCurrentPosition(function (pos){
-            var req = new XMLHttpRequest();
-            req.addEventListener("load", function (){
-              // TODO Fix the message key issue and use descriptive keys!
-              var json = {0:iconNameToId[req.response.currently.icon],                         // id - check the c source
-                          1:Math.round(req.response.currently.apparentTemperature),            // Celsius
-                          2:Math.round(req.response.daily.data[0].apparentTemperatureMax),     // Celsius
-                          3:Math.round(req.response.daily.data[0].apparentTemperatureMin),     // Celsius
-                          4:Math.round(req.response.daily.data[0].precipProbability*100),      // Percents
-                          // cm/h scaled to a byte, >7.6 mm/h is the definition of heavy rain
-                          5:req.response.minutely.data.map(function (el){return Math.min(Math.round(el.precipIntensity/10*255), 255);}).slice(0,60)
-                         };
-/*
-              var json = {WEATHER_ICON_KEY:iconNameToId[req.response.currently.icon],                         // id - check the c source
-                          WEATHER_TEMPERATURE_KEY:Math.round(req.response.currently.apparentTemperature),            // Celsius
-                          WEATHER_TEMPERATUREMAX_KEY:Math.round(req.response.daily.data[0].apparentTemperatureMax),     // Celsius
-                          WEATHER_TEMPERATUREMIN_KEY:Math.round(req.response.daily.data[0].apparentTemperatureMin),     // Celsius
-                          WEATHER_PRECIP_PROB_KEY:Math.round(req.response.daily.data[0].precipProbability*100),      // Percents
-                          // cm/h scaled to a byte, >7.6 mm/h is the definition of heavy rain
-                          WEATHER_PRECIP_ARRAY_KEY:req.response.minutely.data.map(function (el){return Math.min(Math.round(el.precipIntensity/10*255), 255);}).slice(0,60)
-                         };
-*/
-              Pebble.sendAppMessage(json);
-            });
-            req.responseType = 'json';
-            req.open("GET", "https://api.darksky.net/forecast/"+DarkskyKey+"/"+pos.coords.latitude+","+pos.coords.longitude+"?units=si");
-            req.send();
+    if (fetching) {return;} // The fetch in flight schedules the next poll.
+    if (DarkskyKey===null) {
+      // Configuring the key polls at once; until then, check again now and then.
+      schedulePoll(POLL_INTERVAL);
+      return;
+    }
+    fetching = true;
+    try {
+      weather.fetchForecast(DarkskyKey, function (err, forecast){
+        // Cleared before anything can throw, so a bad forecast cannot stop the polling for good.
+        fetching = false;
+        if (err) {
+          pollFailed(err);
+          return;
+        }
+        var levels, json;
+        try {
+          levels = forecast.minutely.map(precipLevel);
+          // TODO Fix the message key issue and use descriptive keys!
+          json = {0:iconNameToId[forecast.icon],                         // id - check the c source
+                  1:Math.round(forecast.temperature),                    // Celsius
+                  2:Math.round(forecast.temperatureMax),                 // Celsius
+                  3:Math.round(forecast.temperatureMin),                 // Celsius
+                  4:Math.round(forecast.precipProbability*100),          // Percents
+                  5:encodePrecip(levels),
+                  9:encodeHourly(forecast.hourly || [])
+                 };
+        } catch (e) {
+          pollFailed("bad forecast: " + e.message);
+          return;
+        }
+        var message = changedKeys(json);
+        // The series is relative to the time it was sent, so a non-empty one is always resent.
+        if (levels.some(function (l){return l > 0;})) {
+          message = message || {};
+          message[5] = json[5];
+        }
+        // Even when nothing changed the watch has to learn that its weather is current.
+        message = message || {0:json[0]};
+        localStorage.setItem("WeatherFetchedAt", Date.now());
+        failures = 0;
+        sendQueued(splitMessage(message), function (){
+          for (var key in message) {lastSent[key] = message[key];}
+          var interval = pollInterval(levels, forecast.precipProbability);
+          localStorage.setItem("WeatherInterval", interval);
+          schedulePoll(interval);
+        }, function (){
+          // The watch is out of reach - it asks for new weather itself once it reconnects.
+          lastSent = {};
+          localStorage.setItem("WeatherInterval", 0);
+          schedulePoll(pollInterval(levels, forecast.precipProbability) * 2);
         });
+      });
+    } catch (e) {
+      // E.g. geolocation throwing instead of calling back.
+      pollFailed(e.message);
     }
 }
 
-Pebble.addEventListener("ready", function() {sendWeather(); setInterval(sendWeather, 10*60*1000);});
\ No newline at end of file
+// Instrumentation of watch builds with STATS_ENABLED (`pebble build -- --stats`), pulled and logged while
+// localStorage "DebugStats" is set. The layout is the `Stats` struct in watchface.c.
+var STATS_VERSION = 4;
+var STATS_INTERVAL = 15*MINUTE;
+var STATS_COUNTERS = ['uptime', 'heapUsed', 'ticks', 'healthEvents', 'messages', 'droppedMessages', 'skippedRedraws',
+                      'frames', 'frameMs', 'taps', 'timers', 'bytesReceived', 'messagesSent', 'bytesSent', 'healthCalls'];
+var STATS_DRAW_NAMES = ['hands', 'seconds', 'battery', 'connection', 'bpm graph', 'bpm', 'distance', 'sleep', 'calories',
+                        'temperature', 'icon', 'precip prob', 'precip graph', 'message'];
+var STATS_HISTOGRAM_BUCKETS = 8;
+
+function requestStats() {
+  Pebble.sendAppMessage({8:1}, null, function (){console.log("Stats request not delivered");});
+}
+
+// Little endian unsigned integer of `size` bytes.
+function readUint(bytes, offset, size) {
+  var value = 0;
+  for (var i = size-1; i >= 0; i--) {value = value*256 + bytes[offset+i];}
+  return value;
+}
+
+function logStats(bytes) {
+  if (bytes[0] !== STATS_VERSION) {
+    console.log("Unknown stats version " + bytes[0]);
+    return;
+  }
+  var s = {};
+  STATS_COUNTERS.forEach(function (name, i){s[name] = readUint(bytes, 1 + 4*i, 4);});
+  // Raw counts only - to compare builds on the same workload, replay a trace with tools/host instead.
+  var wakeups = s.ticks + s.healthEvents + s.messages + s.taps + s.timers;
+  console.log("Stats after " + s.uptime + "s: heap " + s.heapUsed + " bytes, ticks " + s.ticks +
+              ", health events " + s.healthEvents + " (" + s.healthCalls + " queries), taps " + s.taps +
+              ", timers " + s.timers + ", skipped redraws " + s.skippedRedraws);
+  console.log("  " + s.frames + " frames in " + s.frameMs + "ms; received " + s.messages + " messages (" +
+              s.bytesReceived + " bytes, " + s.droppedMessages + " dropped), sent " + s.messagesSent +
+              " (" + s.bytesSent + " bytes); " + wakeups + " wakeups (" +
+              Math.round(wakeups * 3600 / Math.max(s.uptime, 1)) + " per hour)");
+  var offset = 1 + 4*STATS_COUNTERS.length;
+  STATS_DRAW_NAMES.forEach(function (name){
+    var count = readUint(bytes, offset, 4);
+    var total = readUint(bytes, offset+4, 4);
+    var histogram = [];
+    for (var i = 0; i < STATS_HISTOGRAM_BUCKETS; i++) {histogram.push(readUint(bytes, offset+10+2*i, 2));}
+    console.log("  " + name + ": " + count + " draws, avg " + (count ? (total/count).toFixed(1) : 0) +
+                "ms, max " + readUint(bytes, offset+8, 2) + "ms, log2 histogram [" + histogram.join(" ") + "]");
+    offset += 10 + 2*STATS_HISTOGRAM_BUCKETS;
+  });
+}
+
+Pebble.addEventListener("appmessage", function(e) {
+  if (e.payload[7] !== undefined) {watchBattery = e.payload[7];}
+  if (e.payload[8] !== undefined) {logStats(e.payload[8]);}
+  if (e.payload[6] !== undefined) {
+    watchBattery = e.payload[6];
+    // The watch asks once its weather is half an hour old, but a dry day or a low battery polls less often
+    // than that - only a weather the watch never got, or an overdue poll, is fetched early.
+    var fetchedAt = Number(localStorage.getItem("WeatherFetchedAt")) || 0;
+    var interval = Number(localStorage.getItem("WeatherInterval")) || 0;
+    if (Date.now() - fetchedAt >= Math.max(interval, MIN_POLL_GAP)) {
+      failures = 0;
+      schedulePoll(0);
+    }
+  }
+});
+
+// The watch restores its last weather from persistent storage, so a watchface switch shortly after a fetch
+// does not need a new one - the first poll just waits for the rest of the interval.
+Pebble.addEventListener("ready", function() {
+  // Anything the watch sent before now is lost, so ask it for its battery level.
+  Pebble.sendAppMessage({7:0}, null, function (){console.log("Battery request not delivered");});
+  var fetchedAt = Number(localStorage.getItem("WeatherFetchedAt")) || 0;
+  var interval = Number(localStorage.getItem("WeatherInterval")) || POLL_INTERVAL;
+  schedulePoll(Math.max(0, Math.min(interval, fetchedAt + interval - Date.now())));
+  if (localStorage.getItem("DebugStats")) {
+    requestStats();
+    setInterval(requestStats, STATS_INTERVAL);
+  }
+});
\ No newline at end of file
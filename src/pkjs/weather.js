@@ -0,0 +1,147 @@
+// Weather fetching with a location cache, a forecast cache and pluggable providers.
+//
+// A provider turns coordinates into a request URL and the response into a trimmed forecast:
+//   {icon, temperature, temperatureMax, temperatureMin, precipProbability, minutely: [intensity, ...],
+//    hourly: [{time, temperature, precipProbability}, ...]}
+// with `minutely` holding one precipitation intensity (mm/h) per minute starting at `time` (ms), and
+// `hourly` the next 24 hours starting with the current one, `time` in seconds.
+// Only that trimmed forecast is cached.
+
+var MINUTE = 60*1000;
+var POSITION_MAX_AGE = 15*MINUTE;  // A watch does not travel far between polls.
+var FORECAST_MAX_AGE = 5*MINUTE;   // The minutely nowcast goes out of date quickly.
+var REQUEST_TIMEOUT = MINUTE;
+
+function parseDarksky(json) {
+  if (!json || !json.currently || !json.daily || !json.daily.data || !json.daily.data.length) {return null;}
+  var now = Date.now();
+  return {
+    time: now,
+    icon: json.currently.icon,
+    temperature: json.currently.apparentTemperature,
+    temperatureMax: json.daily.data[0].apparentTemperatureMax,
+    temperatureMin: json.daily.data[0].apparentTemperatureMin,
+    precipProbability: json.daily.data[0].precipProbability,
+    // There is no minutely nowcast outside of some regions.
+    minutely: json.minutely ? json.minutely.data.slice(0,60).map(function (el){return el.precipIntensity;}) : [],
+    hourly: json.hourly ? json.hourly.data.slice(0,24).map(function (el){
+      return {time: el.time, temperature: el.apparentTemperature, precipProbability: el.precipProbability};
+    }) : []
+  };
+}
+
+var providers = {
+  darksky: {
+    url: function (key, lat, lon) {
+      return "https://api.darksky.net/forecast/"+key+"/"+lat+","+lon+"?units=si&exclude=alerts,flags";
+    },
+    parse: parseDarksky
+  },
+  // Serves Darksky-shaped JSON from the URL in localStorage "WeatherMockUrl", e.g. a server on the dev machine.
+  mock: {
+    url: function (key, lat, lon) {
+      return localStorage.getItem("WeatherMockUrl")+"?lat="+lat+"&lon="+lon;
+    },
+    parse: parseDarksky
+  }
+};
+
+function provider() {
+  return providers[localStorage.getItem("WeatherProvider")] || providers.darksky;
+}
+
+function readJSON(name) {
+  try {
+    return JSON.parse(localStorage.getItem(name));
+  } catch (e) {
+    return null;
+  }
+}
+
+// Coordinates rounded to about a kilometer - close enough for a forecast, and a stable cache key.
+function round(coordinate) {
+  return Math.round(coordinate*100)/100;
+}
+
+function getPosition(callback) {
+  var cached = readJSON("WeatherPosition");
+  if (cached && Date.now() - cached.time < POSITION_MAX_AGE) {
+    callback(null, cached);
+    return;
+  }
+  navigator.geolocation.getCurrentPosition(function (pos){
+    var position = {lat: round(pos.coords.latitude), lon: round(pos.coords.longitude), time: Date.now()};
+    localStorage.setItem("WeatherPosition", JSON.stringify(position));
+    callback(null, position);
+  }, function (err){
+    callback("geolocation " + err.code);
+  }, {timeout: MINUTE, maximumAge: POSITION_MAX_AGE, enableHighAccuracy: false});
+}
+
+// Drop the minutes of the nowcast that already passed since the forecast was fetched.
+function current(forecast) {
+  var elapsed = Math.floor((Date.now() - forecast.time) / MINUTE);
+  var result = {};
+  for (var key in forecast) {result[key] = forecast[key];}
+  result.minutely = forecast.minutely.slice(elapsed);
+  return result;
+}
+
+// Calls `callback(error, forecast)`, from the cache if a fresh enough forecast for this place is there.
+function fetchForecast(apiKey, callback) {
+  getPosition(function (err, position){
+    if (err) {callback(err); return;}
+    var place = position.lat+","+position.lon;
+    var cached = readJSON("WeatherForecast");
+    if (cached && cached.place === place && Date.now() - cached.forecast.time < FORECAST_MAX_AGE) {
+      callback(null, current(cached.forecast));
+      return;
+    }
+    var source = provider();
+    var req = new XMLHttpRequest();
+    // Exactly one of the listeners below reports, whatever the request does.
+    var done = false;
+    function finish(err, forecast) {
+      if (done) {return;}
+      done = true;
+      callback(err, forecast);
+    }
+    req.addEventListener("load", function (){
+      if (req.status !== 200) {
+        finish("HTTP " + req.status);
+        return;
+      }
+      var forecast;
+      try {
+        // Some runtimes ignore responseType and hand over the text.
+        var json = typeof req.response === "string" ? JSON.parse(req.response) : req.response;
+        forecast = source.parse(json);
+      } catch (e) {
+        finish("bad response: " + e.message);
+        return;
+      }
+      if (!forecast) {
+        finish("bad response");
+        return;
+      }
+      localStorage.setItem("WeatherForecast", JSON.stringify({place: place, forecast: forecast}));
+      finish(null, forecast);
+    });
+    req.addEventListener("error", function (){finish("network error");});
+    req.addEventListener("timeout", function (){finish("timeout");});
+    req.addEventListener("abort", function (){finish("aborted");});
+    try {
+      req.open("GET", source.url(apiKey, position.lat, position.lon));
+      req.responseType = 'json';
+      req.timeout = REQUEST_TIMEOUT;
+      req.send();
+    } catch (e) {
+      finish("request failed: " + e.message);
+    }
+  });
+}
+
+module.exports = {
+  providers: providers,
+  fetchForecast: fetchForecast
+};
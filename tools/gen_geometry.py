@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""Generate src/c/geometry.h - the dial, hand and widget layout tables for every target platform.
+
+The watchface draws from these tables instead of doing trigonometry and layout arithmetic at runtime.
+The wscript and the host build in tools/host fail when the header differs from the script's output; after
+changing the script, regenerate it with:
+
+    python3 tools/gen_geometry.py > src/c/geometry.h
+"""
+import math
+
+FIXED_POINT_SCALE = 16  # pebble-fctx fixed_t has 4 fractional bits.
+
+# (platform macros, width, height). Round displays (chalk) would need a layout of their own - the widgets do
+# not fit between the dial and the bezel.
+PLATFORMS = [
+    (['PBL_PLATFORM_EMERY'], 200, 228),
+    (['PBL_PLATFORM_BASALT', 'PBL_PLATFORM_DIORITE'], 144, 168),
+]
+
+# Pip outlines in pixels, pointing up (outwards at 12 o'clock), by kind.
+PIP_QUARTER = [(0, 2), (3, -10), (-3, -10)]
+PIP_FIVE = [(0, 0), (2, -6), (-2, -6)]
+PIP_MINUTE = [(0, 0), (0, -3), (1, -3), (1, 0)]
+
+
+def fixed(v):
+    return int(round(v * FIXED_POINT_SCALE))
+
+
+def clock_to_cartesian(cx, cy, rx, ry, angle):
+    """A point on the ellipse around (cx, cy) with radii rx, ry: angle in turns, 0 is 12 o'clock, clockwise."""
+    return cx + math.sin(2*math.pi*angle) * rx, cy - math.cos(2*math.pi*angle) * ry
+
+
+def rotate(x, y, angle):
+    """Same rotation as pebble-fctx applies with fctx_set_rotation."""
+    c, s = math.cos(2*math.pi*angle), math.sin(2*math.pi*angle)
+    return x*c - y*s, x*s + y*c
+
+
+def pip_polygons(w, h):
+    rows = []
+    for m in range(60):
+        angle = m / 60
+        px, py = clock_to_cartesian(w/2, h/2, w/3, h/3, angle)
+        outline = PIP_QUARTER if m % 15 == 0 else PIP_FIVE if m % 5 == 0 else PIP_MINUTE
+        points = [rotate(x, y, angle) for x, y in outline]
+        points = [(px + x, py + y) for x, y in points]
+        points += [points[-1]] * (4 - len(points))
+        rows.append(points)
+    return rows
+
+
+def minute_hand(w, h):
+    rows = []
+    for m in range(60):
+        angle = m / 60
+        rows.append([clock_to_cartesian(w/2, h/2, w/3, h/3, angle),
+                     clock_to_cartesian(w/2, h/2, w*8/30, h*8/30, angle + 1/60),
+                     clock_to_cartesian(w/2, h/2, w*8/30, h*8/30, angle - 1/60)])
+    return rows
+
+
+def second_hand(w, h):
+    """A two pixel wide needle from the center to the inner end of the minute hand."""
+    rows = []
+    for sec in range(60):
+        angle = sec / 60
+        tip = clock_to_cartesian(w/2, h/2, w*8/30 - 2, h*8/30 - 2, angle)
+        dx, dy = rotate(1, 0, angle)
+        rows.append([(w//2 + dx, h//2 + dy), (tip[0] + dx, tip[1] + dy),
+                     (tip[0] - dx, tip[1] - dy), (w//2 - dx, h//2 - dy)])
+    return rows
+
+
+def layout(w, h):
+    return [
+        ('LAYOUT_BATTERY',           (1, h//2-16, 10, 17)),
+        ('LAYOUT_CONNECTION',        (2, h//2+4, 7, 13)),
+        ('LAYOUT_HEALTH_BPM_GRAPH',  (1, 1, 34, 22)),
+        ('LAYOUT_HEALTH_BPM_TEXT',   (1, 24, w//4, 14)),
+        ('LAYOUT_HEALTH_METERS',     (1, h-43, w//4, 14)),
+        ('LAYOUT_HEALTH_SLEEP',      (1, h-29, w*2//5-3, 14)),
+        ('LAYOUT_HEALTH_CALS',       (1, h-15, w//2, 14)),
+        # The maximum and minimum are left aligned in 20 px boxes from 20 px in, past the screen's edge.
+        ('LAYOUT_WEATHER_TEMP',      (w-32, h//2, 40, 30)),
+        ('LAYOUT_WEATHER_ICON',      (w-29, h*21//30-1, 25, 25)),
+        ('LAYOUT_WEATHER_PRECIPPROB', (w-20, h-30, 20, 30)),
+        ('LAYOUT_WEATHER_PRECIPGRAPH', (w//2+4, h-27, 49, 27)),
+        ('LAYOUT_MY_MESSAGE',        (37, 0, w-37, 14)),
+        ('LAYOUT_TIME',              (w//3, h*2//3-18, w//3, 18)),
+        ('LAYOUT_DATE',              (w//3, h*2//3, w//3, 15)),
+    ]
+
+
+def fpoint(p):
+    return 'FPoint({}, {})'.format(fixed(p[0]), fixed(p[1]))
+
+
+def emit_platform(w, h):
+    out = []
+    out.append('#define GEOMETRY_SCREEN_SIZE GSize({}, {})'.format(w, h))
+    out.append('#define GEOMETRY_DIAL_CENTER FPoint({}, {})'.format(fixed(w//2), fixed(h//2)))
+    out.append('')
+    for name, rect in layout(w, h):
+        out.append('#define {} GRect({}, {}, {}, {})'.format(name, *rect))
+    out.append('')
+    out.append('// Pip outlines in fixed point screen coordinates, triangles repeat their last vertex.')
+    out.append('static const FPoint PIP_POLYGONS[60][4] = {')
+    for points in pip_polygons(w, h):
+        out.append('    {' + ', '.join(fpoint(p) for p in points) + '},')
+    out.append('};')
+    out.append('')
+    out.append('// Minute hand tip and the two base corners, per minute.')
+    out.append('static const FPoint MINUTE_HAND[60][3] = {')
+    for points in minute_hand(w, h):
+        out.append('    {' + ', '.join(fpoint(p) for p in points) + '},')
+    out.append('};')
+    out.append('')
+    out.append('// Seconds hand outline, per second.')
+    out.append('static const FPoint SECOND_HAND[60][4] = {')
+    for points in second_hand(w, h):
+        out.append('    {' + ', '.join(fpoint(p) for p in points) + '},')
+    out.append('};')
+    return out
+
+
+def main():
+    out = ['// Generated by tools/gen_geometry.py - do not edit.', '',
+           '#pragma once', '', '#include <pebble.h>', '#include <pebble-fctx/fctx.h>', '']
+    for i, (macros, w, h) in enumerate(PLATFORMS):
+        condition = ' || '.join('defined({})'.format(m) for m in macros)
+        out.append('{} {}'.format('#if' if i == 0 else '#elif', condition))
+        out.append('')
+        out += emit_platform(w, h)
+        out.append('')
+    out.append('#else')
+    out.append('#error "No geometry for this platform - add it to tools/gen_geometry.py."')
+    out.append('#endif')
+    print('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,181 @@
+// The reference rasterizer behind the stand-in fctx.h.
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "host.h"
+#include "pebble-fctx/fctx.h"
+
+#define SUBPIXELS 16 // Samples per pixel and axis - one per fixed point unit.
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+
+struct FEdge {
+    FPoint a;
+    FPoint b;
+};
+
+void fctx_init_context(FContext* fctx, GContext* gctx) {
+    *fctx = (FContext){
+        .gctx = gctx,
+        .fill_color = GColorWhite,
+        .scale_from = FPoint(1, 1),
+        .scale_to = FPoint(1, 1),
+    };
+}
+
+void fctx_deinit_context(FContext* fctx) {
+    free(fctx->edges);
+    fctx->edges = NULL;
+    fctx->edge_count = fctx->edge_capacity = 0;
+}
+
+void fctx_set_fill_color(FContext* fctx, GColor c) {
+    fctx->fill_color = c;
+}
+
+void fctx_set_color_bias(FContext* fctx, int16_t bias) {
+    fctx->color_bias = bias;
+}
+
+void fctx_set_offset(FContext* fctx, FPoint offset) {
+    fctx->offset = offset;
+}
+
+void fctx_set_scale(FContext* fctx, FPoint scale_from, FPoint scale_to) {
+    fctx->scale_from = scale_from;
+    fctx->scale_to = scale_to;
+}
+
+void fctx_set_rotation(FContext* fctx, uint32_t rotation) {
+    fctx->rotation = rotation;
+}
+
+static FPoint transform(const FContext* fctx, FPoint p) {
+    int64_t x = (int64_t)p.x * fctx->scale_to.x / fctx->scale_from.x;
+    int64_t y = (int64_t)p.y * fctx->scale_to.y / fctx->scale_from.y;
+    int64_t c = cos_lookup(fctx->rotation);
+    int64_t s = sin_lookup(fctx->rotation);
+    return FPoint((fixed_t)((x*c - y*s) / TRIG_MAX_RATIO) + fctx->offset.x,
+                  (fixed_t)((x*s + y*c) / TRIG_MAX_RATIO) + fctx->offset.y);
+}
+
+static void add_edge(FContext* fctx, FPoint a, FPoint b) {
+    if (a.y == b.y) {
+        return; // Horizontal edges cross no sample row.
+    }
+    if (fctx->edge_count == fctx->edge_capacity) {
+        fctx->edge_capacity = fctx->edge_capacity ? fctx->edge_capacity * 2 : 64;
+        fctx->edges = realloc(fctx->edges, fctx->edge_capacity * sizeof(FEdge));
+    }
+    fctx->edges[fctx->edge_count++] = (FEdge){a, b};
+}
+
+void fctx_begin_fill(FContext* fctx) {
+    fctx->edge_count = 0;
+}
+
+void fctx_move_to(FContext* fctx, FPoint p) {
+    fctx_close_path(fctx);
+    fctx->path_start = fctx->path_cursor = transform(fctx, p);
+}
+
+void fctx_line_to(FContext* fctx, FPoint p) {
+    FPoint q = transform(fctx, p);
+    add_edge(fctx, fctx->path_cursor, q);
+    fctx->path_cursor = q;
+}
+
+void fctx_close_path(FContext* fctx) {
+    add_edge(fctx, fctx->path_cursor, fctx->path_start);
+    fctx->path_cursor = fctx->path_start;
+}
+
+// A 32 sided polygon through the transform, like the library approximates circles with lines.
+void fctx_plot_circle(FContext* fctx, const FPoint* c, fixed_t r) {
+    for (int i = 0; i <= 32; i++) {
+        int32_t angle = TRIG_MAX_ANGLE * i / 32;
+        FPoint p = FPoint(c->x + r * cos_lookup(angle) / TRIG_MAX_RATIO, c->y + r * sin_lookup(angle) / TRIG_MAX_RATIO);
+        if (i == 0) {
+            fctx_move_to(fctx, p);
+        } else {
+            fctx_line_to(fctx, p);
+        }
+    }
+    fctx_close_path(fctx);
+}
+
+typedef struct {
+    double x;
+    int winding;
+} Crossing;
+
+static int compare_crossings(const void* a, const void* b) {
+    double d = ((const Crossing*)a)->x - ((const Crossing*)b)->x;
+    return (d > 0) - (d < 0);
+}
+
+void fctx_end_fill(FContext* fctx) {
+    fctx_close_path(fctx);
+    host_counters.primitives += 1;
+    if (fctx->edge_count == 0) {
+        return;
+    }
+    fixed_t top = INT32_MAX, bottom = INT32_MIN, left = INT32_MAX, right = INT32_MIN;
+    for (uint32_t i = 0; i < fctx->edge_count; i++) {
+        const FEdge* e = &fctx->edges[i];
+        top = min(top, min(e->a.y, e->b.y));
+        bottom = max(bottom, max(e->a.y, e->b.y));
+        left = min(left, min(e->a.x, e->b.x));
+        right = max(right, max(e->a.x, e->b.x));
+    }
+    GRect screen = gbitmap_get_bounds(host_frame_buffer());
+    int y0 = max(top / SUBPIXELS - 1, 0);
+    int y1 = min(bottom / SUBPIXELS + 1, screen.size.h - 1);
+    int x0 = max(left / SUBPIXELS - 1, 0);
+    int x1 = min(right / SUBPIXELS + 1, screen.size.w - 1);
+    if (x0 > x1) {
+        return;
+    }
+    int width = x1 - x0 + 1;
+    int* coverage = malloc(width * sizeof(int));
+    Crossing* crossings = malloc(fctx->edge_count * sizeof(Crossing));
+    for (int y = y0; y <= y1; y++) {
+        memset(coverage, 0, width * sizeof(int));
+        for (int sub_y = 0; sub_y < SUBPIXELS; sub_y++) {
+            double sy = y * SUBPIXELS + sub_y + 0.5;
+            int count = 0;
+            for (uint32_t i = 0; i < fctx->edge_count; i++) {
+                const FEdge* e = &fctx->edges[i];
+                if ((e->a.y <= sy) == (e->b.y <= sy)) {
+                    continue;
+                }
+                double t = (sy - e->a.y) / (e->b.y - e->a.y);
+                crossings[count++] = (Crossing){e->a.x + t * (e->b.x - e->a.x), e->b.y > e->a.y ? 1 : -1};
+            }
+            qsort(crossings, count, sizeof(Crossing), compare_crossings);
+            int winding = 0;
+            for (int i = 0; i + 1 < count; i++) {
+                winding += crossings[i].winding;
+                if (winding == 0) {
+                    continue;
+                }
+                // Sample columns whose centers lie in the span.
+                int s0 = max((int)ceil(crossings[i].x - 0.5), x0 * SUBPIXELS);
+                int s1 = min((int)ceil(crossings[i + 1].x - 0.5), (x1 + 1) * SUBPIXELS);
+                for (int s = s0; s < s1; s++) {
+                    coverage[s / SUBPIXELS - x0] += 1;
+                }
+            }
+        }
+        for (int x = x0; x <= x1; x++) {
+            if (coverage[x - x0]) {
+                host_cover_pixel(fctx->gctx, x, y, fctx->fill_color, coverage[x - x0]);
+            }
+        }
+    }
+    free(crossings);
+    free(coverage);
+    fctx->edge_count = 0;
+}
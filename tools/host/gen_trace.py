@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""Generate a synthetic day of watch events for tools/host/replay.c.
+
+    python3 tools/host/gen_trace.py [--seed N] > day.trace
+
+The day is made up but plausible, and the same seed always gives the same trace, so builds can be compared
+on identical workloads:
+
+- asleep from midnight to 07:00, with restful phases and the odd movement;
+- up and about until 23:00: heart rate updates, bursts of movement updates and growing health sums;
+- taps now and then, the watch off the wrist from 19:00 to 20:15;
+- Bluetooth gone from 12:30 to 12:50;
+- weather from the phone on the schedule index.js polls at, with rain in the afternoon;
+- the battery running down from 90%.
+"""
+import argparse
+import random
+
+START = 1476662400  # Monday, 17 October 2016, 00:00 UTC - the golden images' day.
+DAY = 24 * 3600
+
+WAKE_UP = 7 * 3600
+BED_TIME = 23 * 3600
+OFF_WRIST = (19 * 3600, 20 * 3600 + 15 * 60)
+DISCONNECTED = (12 * 3600 + 30 * 60, 12 * 3600 + 50 * 60)
+RAIN = (14 * 3600 + 20 * 60, 16 * 3600)
+
+# Encodings from index.js.
+PRECIP_ENCODING_VERSION = 1
+HOURLY_ENCODING_VERSION = 1
+HOURLY_HOURS = 24
+
+# Keys from package.json.
+WEATHER_ICON, TEMPERATURE, TEMPERATURE_MAX, TEMPERATURE_MIN, PRECIP_PROB, PRECIP_ARRAY = range(6)
+WATCH_BATTERY, WEATHER_HOURLY = 7, 9
+RAIN_ICON, PARTLY_CLOUDY_DAY, CLEAR_NIGHT = 3, 9, 2
+
+
+def encode_precip(levels):
+    out, i = [PRECIP_ENCODING_VERSION], 0
+    while i < len(levels):
+        run = 1
+        while run < 16 and i + run < len(levels) and levels[i + run] == levels[i]:
+            run += 1
+        out.append((run - 1) << 4 | levels[i])
+        i += run
+    return out
+
+
+def encode_hourly(start, temps, probabilities):
+    out = [HOURLY_ENCODING_VERSION] + [(start >> (8 * i)) & 0xff for i in range(4)]
+    out += [t & 0xff for t in temps]
+    out += [probabilities[i] | probabilities[i + 1] << 4 for i in range(0, HOURLY_HOURS, 2)]
+    return out
+
+
+def temperature(t):
+    """Degrees at `t` seconds into the day - coldest at dawn, warmest mid-afternoon."""
+    hour = t / 3600 % 24
+    return round(6 + 8 * max(0, 1 - abs(hour - 15) / 9))
+
+
+def raining_in(t, minutes):
+    return RAIN[0] <= t + minutes * 60 < RAIN[1]
+
+
+def weather_message(t, last):
+    """The keys index.js would send at `t`: the changed ones, a rain series whenever rain is near."""
+    levels = [(6 + (m % 7)) if raining_in(t, m) else 0 for m in range(60)]
+    rain_soon = any(levels)
+    probability = 80 if rain_soon else 30 if RAIN[0] - 3 * 3600 <= t < RAIN[1] else 5
+    hour = t - t % 3600
+    hourly = encode_hourly(START + hour,
+                           [temperature(hour + 3600 * i) for i in range(HOURLY_HOURS)],
+                           [12 if RAIN[0] <= hour + 3600 * i < RAIN[1] else 1 for i in range(HOURLY_HOURS)])
+    night = t < WAKE_UP or t >= 19 * 3600
+    full = {
+        WEATHER_ICON: RAIN_ICON if rain_soon else CLEAR_NIGHT if night else PARTLY_CLOUDY_DAY,
+        TEMPERATURE: temperature(t),
+        TEMPERATURE_MAX: 14,
+        TEMPERATURE_MIN: 6,
+        PRECIP_PROB: probability,
+        PRECIP_ARRAY: encode_precip(levels),
+        WEATHER_HOURLY: hourly,
+    }
+    message = {k: v for k, v in full.items() if last.get(k) != v}
+    if rain_soon:
+        message[PRECIP_ARRAY] = full[PRECIP_ARRAY]
+    if not message:
+        message = {WEATHER_ICON: full[WEATHER_ICON]}
+    last.update(message)
+    interval = 5 if rain_soon else 10 if probability >= 30 else 30
+    return message, interval * 60
+
+
+# The watch's inbox size - index.js splits larger messages the same way.
+MESSAGE_BUF = 128
+
+
+def message_size(message):
+    return 1 + sum(7 + (len(v) if isinstance(v, list) else 4) for v in message.values())
+
+
+def split_message(message):
+    parts, part = [], {}
+    for key, value in message.items():
+        part[key] = value
+        if message_size(part) > MESSAGE_BUF and len(part) > 1:
+            del part[key]
+            parts.append(part)
+            part = {key: value}
+    parts.append(part)
+    return parts
+
+
+def format_message(message):
+    fields = []
+    for key, value in sorted(message.items()):
+        fields.append('{}={}'.format(key, 'x' + bytes(value).hex() if isinstance(value, list) else value))
+    return 'message ' + ' '.join(fields)
+
+
+def generate(rng):
+    events = []
+
+    def add(t, text):
+        events.append((t, len(events), text))
+
+    # index.js asks for the battery level once it is ready.
+    add(2, 'message {}=0'.format(WATCH_BATTERY))
+
+    # Heart rate and activity.
+    asleep = True
+    add(0, 'activity sleep')
+    for t in range(0, DAY, 60):
+        if t == WAKE_UP:
+            add(t, 'activity none')
+            asleep = False
+        elif t == BED_TIME:
+            add(t, 'activity sleep')
+            asleep = True
+        if asleep and t % 3600 == 1800:
+            add(t, 'activity restful')
+        elif asleep and t % 3600 == 2700:
+            add(t, 'activity sleep')
+        off_wrist = OFF_WRIST[0] <= t < OFF_WRIST[1]
+        if t % (600 if asleep else 300) == 0:
+            add(t + 5, 'bpm {}'.format(0 if off_wrist else rng.randint(50, 58) if asleep else rng.randint(62, 95)))
+        # Movement updates come in bursts while awake, and rarely while asleep.
+        if not off_wrist and rng.random() < (0.01 if asleep else 0.25):
+            for i in range(rng.randint(1, 4)):
+                add(t + 10 + i, 'movement')
+
+    # Health sums, updated with the movement.
+    steps = 0
+    for t in range(WAKE_UP, BED_TIME, 900):
+        steps += rng.randint(100, 900)
+        add(t + 1, 'sum steps {}'.format(steps))
+        add(t + 1, 'sum walked {}'.format(steps * 7 // 10))
+        add(t + 1, 'sum active_kcal {}'.format(steps // 25))
+        add(t + 1, 'sum resting_kcal {}'.format(1400 * t // DAY))
+    add(WAKE_UP, 'sum sleep {}'.format(WAKE_UP - 1200))
+    add(WAKE_UP, 'sum restful {}'.format(WAKE_UP // 3))
+
+    # Taps, a few of them double.
+    for _ in range(40):
+        t = rng.randint(WAKE_UP, BED_TIME)
+        add(t, 'tap')
+        if rng.random() < 0.3:
+            add(t + rng.randint(2, 8), 'tap')
+
+    add(DISCONNECTED[0], 'connection 0')
+    add(DISCONNECTED[1], 'connection 1')
+
+    # Weather, not while disconnected.
+    last, t = {}, 30
+    while t < DAY:
+        if not DISCONNECTED[0] <= t < DISCONNECTED[1]:
+            message, interval = weather_message(t, last)
+            for i, part in enumerate(split_message(message)):
+                add(t + i, format_message(part))
+        else:
+            interval = DISCONNECTED[1] - t + 15
+        t += interval
+
+    # The battery, a percent every 20 minutes or so.
+    battery = 90
+    for t in range(1200, DAY, 1200):
+        battery -= 1 if rng.random() < 0.9 else 0
+        add(t + rng.randint(0, 60), 'battery {} 0'.format(battery))
+
+    return sorted(events)
+
+
+def clock(t):
+    return '{}:{:02d}:{:02d}'.format(t // 3600, t // 60 % 60, t % 60)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--seed', type=int, default=2016)
+    args = parser.parse_args()
+    rng = random.Random(args.seed)
+    print('# Generated by tools/host/gen_trace.py --seed {}.'.format(args.seed))
+    print('start {}'.format(START))
+    print('0:00:00 battery 90 0')
+    print('0:00:00 bpm 54')
+    print('0:00:00 activity sleep')
+    print('0:00:00 init')
+    for t, _, text in generate(rng):
+        print('{} {}'.format(clock(t), text))
+    print('{} end'.format(clock(DAY)))
+
+
+if __name__ == '__main__':
+    main()
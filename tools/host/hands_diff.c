@@ -0,0 +1,106 @@
+// Diffs the two hand rasterizers of watchface.c - the scanline fill and pebble-fctx - at all 720 minutes of
+// the dial. The scanline fill has no antialiasing, so the images may differ on the edges of the hands, but
+// nowhere else.
+//
+//     hands_diff [--out DIR]
+//
+// --out writes the diff at the minute with the most differing pixels: white where the images differ off
+// the edges, gray where they differ on them.
+
+#include <stdlib.h>
+
+#include "host.h"
+
+void hands_render_scanline(int hour, int minute);
+void hands_render_fctx(int hour, int minute);
+
+// A pixel on an edge of `image`: one of its neighbours has another color.
+static bool on_edge(const GColor* image, int w, int h, int x, int y) {
+    GColor color = image[y * w + x];
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            int nx = x + dx;
+            int ny = y + dy;
+            if (nx >= 0 && ny >= 0 && nx < w && ny < h && !gcolor_equal(image[ny * w + nx], color)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void snapshot(GColor* image, int w, int h) {
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            image[y * w + x] = host_frame_pixel(x, y);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* out_dir = argc == 3 && strcmp(argv[1], "--out") == 0 ? argv[2] : NULL;
+    GRect bounds = gbitmap_get_bounds(host_frame_buffer());
+    int w = bounds.size.w;
+    int h = bounds.size.h;
+    GColor* scanline = malloc(w * h * sizeof(GColor));
+    GColor* fctx = malloc(w * h * sizeof(GColor));
+    uint8_t* worst_diff = calloc(w * h, 1); // 0 - same, 1 - differs on an edge, 2 - differs elsewhere.
+    uint8_t* diff = malloc(w * h);
+    int total = 0;
+    int off_edge = 0;
+    int worst = -1;
+    int worst_minute = 0;
+    for (int minute = 0; minute < 12 * 60; minute++) {
+        hands_render_scanline(minute / 60, minute % 60);
+        snapshot(scanline, w, h);
+        hands_render_fctx(minute / 60, minute % 60);
+        snapshot(fctx, w, h);
+        int differences = 0;
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                int i = y * w + x;
+                diff[i] = 0;
+                if (gcolor_equal(scanline[i], fctx[i])) {
+                    continue;
+                }
+                differences += 1;
+                if (on_edge(scanline, w, h, x, y) || on_edge(fctx, w, h, x, y)) {
+                    diff[i] = 1;
+                } else {
+                    diff[i] = 2;
+                    off_edge += 1;
+                    if (off_edge <= 10) {
+                        printf("%s %02d:%02d: pixel %d,%d differs off the edges\n", PLATFORM_NAME, minute / 60,
+                               minute % 60, x, y);
+                    }
+                }
+            }
+        }
+        total += differences;
+        if (differences > worst) {
+            worst = differences;
+            worst_minute = minute;
+            memcpy(worst_diff, diff, w * h);
+        }
+    }
+    printf("%-8s hands     %s  720 minutes, %d pixels differ (most %d at %02d:%02d), %d off the edges\n",
+           PLATFORM_NAME, off_edge ? "FAIL" : "ok  ", total, worst, worst_minute / 60, worst_minute % 60, off_edge);
+    if (out_dir) {
+        GContext* ctx = host_graphics_context();
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                static const GColor colors[3] = {GColorBlack, GColorLightGray, GColorWhite};
+                graphics_context_set_stroke_color(ctx, colors[worst_diff[y * w + x]]);
+                graphics_draw_pixel(ctx, GPoint(x, y));
+            }
+        }
+        char path[256];
+        snprintf(path, sizeof path, "%s/%s-hands-diff.%s", out_dir, PLATFORM_NAME, PBL_IF_BW_ELSE("pbm", "ppm"));
+        host_write_image(path, host_frame_buffer());
+    }
+    free(diff);
+    free(worst_diff);
+    free(fctx);
+    free(scanline);
+    return off_edge != 0;
+}
@@ -0,0 +1,30 @@
+// One of the two hand rasterizers of watchface.c, for hands_diff.c. Built twice, with SCANLINE_HANDS 1
+// and 0 and HANDS_RENDER naming the entry point of each.
+
+#include "host.h"
+
+#define PASTE(a, b) a ## b
+#define NAME(a, b) PASTE(a, b)
+#define main NAME(HANDS_RENDER, _main)
+#include "watchface.c"
+#undef main
+
+// Draw the hands for hour:minute over the bare dial, into the whole screen.
+void HANDS_RENDER(int hour, int minute) {
+    GContext* ctx = host_graphics_context();
+    if (!g_dial_bitmap) {
+        GRect bounds = gbitmap_get_bounds(host_frame_buffer());
+        graphics_context_set_fill_color(ctx, GColorBlack);
+        graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+        FContext fctx;
+        fctx_init_context(&fctx, ctx);
+        draw_dial(&fctx);
+        fctx_deinit_context(&fctx);
+        dial_cache_store(ctx, bounds.size);
+        g_font_time = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
+        g_font_date = fonts_get_system_font(FONT_KEY_GOTHIC_14_BOLD);
+    }
+    g_local_time = (struct tm){.tm_hour = hour, .tm_min = minute};
+    dial_cache_restore(ctx, gbitmap_get_bounds(g_dial_bitmap));
+    render_hands(ctx, hands_rect(), NULL);
+}
@@ -0,0 +1,112 @@
+// The harness side of the stand-in SDK: the simulated clock and event delivery, the state behind the
+// services, the frame buffer and the counters. Harnesses include watchface.c (with its `main` renamed),
+// so they can call its static handlers and look at its state directly.
+
+#pragma once
+
+#include <pebble.h>
+
+// --------------------------------------------------------------------------
+// Counters.
+// --------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t wakeups;            // Events handed to the app: ticks, timers, service events and inbox messages.
+    uint32_t ticks;
+    uint32_t timers;
+    uint32_t taps;
+    uint32_t battery_events;
+    uint32_t connection_events;
+    uint32_t health_events;
+    uint32_t frames;
+    uint64_t frame_us;           // Host time spent drawing frames.
+    uint32_t primitives;         // Drawing calls, fctx fills and frame buffer captures.
+    uint32_t pixels;             // Pixels written by drawing calls, plus pixels changed while the frame buffer was captured.
+    uint32_t health_calls;       // Health service queries.
+    uint32_t messages_received;
+    uint32_t bytes_received;
+    uint32_t messages_dropped;   // Too large for the inbox.
+    uint32_t messages_rejected;  // Sent while the inbox was not open.
+    uint32_t messages_sent;
+    uint32_t bytes_sent;
+    uint32_t send_failures;      // Outbox not open, busy or not connected.
+    uint32_t persist_writes;
+    uint32_t persist_bytes;
+} HostCounters;
+
+extern HostCounters host_counters;
+
+// Messages the watchface sends, e.g. for a harness that plays the phone. May be NULL.
+extern void (*host_outbox_hook)(DictionaryIterator* iter);
+
+extern bool host_verbose; // Print APP_LOG output.
+
+// --------------------------------------------------------------------------
+// Clock and events.
+// --------------------------------------------------------------------------
+
+// Set the clock before `init`; afterwards time only moves forward through `host_run_until`.
+void host_set_time(time_t t);
+int64_t host_now_ms(void);
+
+// Advance the clock to `t_ms`, delivering ticks and timers on the way. Frames are drawn after every event
+// that marked a layer dirty, like the compositor does.
+void host_run_until(int64_t t_ms);
+
+// Draw a frame now if a layer is dirty.
+void host_flush(void);
+
+// Service events. Each delivers the event like the system would and then flushes.
+void host_set_battery(uint8_t percent, bool charging);
+void host_set_connected(bool connected);
+void host_tap(void);
+
+// --------------------------------------------------------------------------
+// Health.
+// --------------------------------------------------------------------------
+
+// The value `health_service_sum_today` returns.
+void host_health_set_sum(HealthMetric metric, HealthValue value);
+
+// The current heart rate, 0 - none (e.g. off-wrist). Every minute the clock passes records it in the minute
+// history. With `notify` a HealthEventHeartRateUpdate is delivered.
+void host_health_set_bpm(uint8_t bpm, bool notify);
+
+// Fill the minute history before the current time with `bpm(minute)`, `minute` counting back from 1.
+void host_health_fill_history(int minutes, uint8_t (*bpm)(int minute));
+
+void host_health_set_activities(HealthActivityMask activities);
+void host_health_set_heart_rate_available(bool available);
+void host_health_event(HealthEventType event);
+
+// --------------------------------------------------------------------------
+// Messages.
+// --------------------------------------------------------------------------
+
+// Build a message from the phone and deliver it. Tuples are added in order.
+void host_inbox_begin(void);
+void host_inbox_add_int(uint32_t key, int32_t value);
+void host_inbox_add_data(uint32_t key, const uint8_t* data, uint16_t length);
+void host_inbox_deliver(void);
+
+// --------------------------------------------------------------------------
+// Frame buffer.
+// --------------------------------------------------------------------------
+
+GBitmap* host_frame_buffer(void);
+
+// A context for the whole screen, for drawing outside of a frame (e.g. a single widget in a benchmark).
+GContext* host_graphics_context(void);
+
+// Pixel of the frame buffer as a color, gray dithering of black and white screens included.
+GColor host_frame_pixel(int x, int y);
+
+// Cover a pixel, in layer coordinates, with `color` for `coverage` 256ths of its area. Color frame buffers
+// blend, black and white ones take the color from half coverage on. For the fctx stand-in.
+void host_cover_pixel(GContext* ctx, int x, int y, GColor color, int coverage);
+
+// Frame buffers are written as PBM (black and white) or PPM (color) files.
+bool host_write_image(const char* path, const GBitmap* fb);
+
+// Pixels in which `fb` differs from the image at `path`, -1 when it cannot be read or has another size.
+int host_compare_image(const char* path, const GBitmap* fb);
@@ -0,0 +1,56 @@
+// Stand-in for pebble-fctx - the path API watchface.c uses, over a reference rasterizer in fctx_host.c.
+//
+// Paths are transformed like pebble-fctx does it (scale, then rotation, then offset) and filled with the
+// non-zero winding rule. Every pixel gets the exact coverage of the path at 16 x 16 samples; color frame
+// buffers blend the fill by coverage, black and white ones fill pixels at least half covered. That is
+// close to, but not bit for bit the same as, the real library's antialiasing.
+
+#pragma once
+
+#include <pebble.h>
+
+typedef int32_t fixed_t;
+
+#define FIXED_POINT_SHIFT 4
+#define FIXED_POINT_SCALE 16
+#define INT_TO_FIXED(a) ((a) * FIXED_POINT_SCALE)
+#define FIXED_TO_INT(a) ((a) / FIXED_POINT_SCALE)
+
+typedef struct FPoint {
+    fixed_t x;
+    fixed_t y;
+} FPoint;
+#define FPoint(x, y) ((FPoint){(x), (y)})
+#define FPointI(x, y) ((FPoint){INT_TO_FIXED(x), INT_TO_FIXED(y)})
+#define FPointZero FPoint(0, 0)
+
+typedef struct FEdge FEdge;
+
+typedef struct FContext {
+    GContext* gctx;
+    GColor fill_color;
+    int16_t color_bias;
+    FPoint offset;
+    FPoint scale_from;
+    FPoint scale_to;
+    uint32_t rotation;
+    FPoint path_start;     // Of the current subpath, transformed.
+    FPoint path_cursor;
+    FEdge* edges;
+    uint32_t edge_count;
+    uint32_t edge_capacity;
+} FContext;
+
+void fctx_init_context(FContext* fctx, GContext* gctx);
+void fctx_deinit_context(FContext* fctx);
+void fctx_set_fill_color(FContext* fctx, GColor c);
+void fctx_set_color_bias(FContext* fctx, int16_t bias);
+void fctx_set_offset(FContext* fctx, FPoint offset);
+void fctx_set_scale(FContext* fctx, FPoint scale_from, FPoint scale_to);
+void fctx_set_rotation(FContext* fctx, uint32_t rotation);
+void fctx_begin_fill(FContext* fctx);
+void fctx_move_to(FContext* fctx, FPoint p);
+void fctx_line_to(FContext* fctx, FPoint p);
+void fctx_close_path(FContext* fctx);
+void fctx_plot_circle(FContext* fctx, const FPoint* c, fixed_t r);
+void fctx_end_fill(FContext* fctx);
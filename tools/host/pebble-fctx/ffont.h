@@ -0,0 +1,5 @@
+// Stand-in for pebble-fctx's font support - watchface.c includes it but draws no fctx text.
+
+#pragma once
+
+#include "fctx.h"
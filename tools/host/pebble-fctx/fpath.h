@@ -0,0 +1,5 @@
+// Stand-in for pebble-fctx's SVG path support - watchface.c includes it but draws no SVG paths.
+
+#pragma once
+
+#include "fctx.h"
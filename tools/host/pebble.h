@@ -0,0 +1,485 @@
+// Stand-in for the Pebble SDK header - just enough of the API for src/c/watchface.c to build and run on
+// Linux, unchanged. The implementations are in pebble_host.c; host.h is the side the harnesses drive.
+//
+// Names, types and constants follow the SDK (3.x) where watchface.c can see them. Anything the watchface
+// does not use is left out.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// --------------------------------------------------------------------------
+// Platform.
+// --------------------------------------------------------------------------
+
+// The Makefile builds one binary per platform, with the SDK's platform macros.
+#if defined(PBL_PLATFORM_DIORITE)
+#define PBL_BW 1
+#define PBL_DISPLAY_WIDTH 144
+#define PBL_DISPLAY_HEIGHT 168
+#elif defined(PBL_PLATFORM_BASALT)
+#define PBL_COLOR 1
+#define PBL_DISPLAY_WIDTH 144
+#define PBL_DISPLAY_HEIGHT 168
+#elif defined(PBL_PLATFORM_EMERY)
+#define PBL_COLOR 1
+#define PBL_DISPLAY_WIDTH 200
+#define PBL_DISPLAY_HEIGHT 228
+#else
+#error "Define PBL_PLATFORM_DIORITE, PBL_PLATFORM_BASALT or PBL_PLATFORM_EMERY."
+#endif
+
+#define PBL_HEALTH 1
+#define PBL_RECT 1
+
+#if defined(PBL_BW)
+#define PBL_IF_BW_ELSE(if_true, if_false) (if_true)
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_false)
+#else
+#define PBL_IF_BW_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+#endif
+
+// --------------------------------------------------------------------------
+// Time and logging.
+// --------------------------------------------------------------------------
+
+// The watchface only ever sees the simulated clock. `time_ms` is only used for durations, so it reads the
+// host's monotonic clock instead - simulated time does not pass while a handler runs.
+time_t host_time(time_t* t);
+#define time(t) host_time(t)
+uint16_t time_ms(time_t* t, uint16_t* ms);
+
+#define SECONDS_PER_MINUTE 60
+#define SECONDS_PER_HOUR 3600
+#define SECONDS_PER_DAY 86400
+
+typedef enum {
+    APP_LOG_LEVEL_ERROR = 1,
+    APP_LOG_LEVEL_WARNING = 50,
+    APP_LOG_LEVEL_INFO = 100,
+    APP_LOG_LEVEL_DEBUG = 200,
+    APP_LOG_LEVEL_DEBUG_VERBOSE = 255,
+} AppLogLevel;
+
+void app_log(uint8_t log_level, const char* src_filename, int src_line_number, const char* fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+#define APP_LOG(level, fmt, ...) app_log(level, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+
+#define ARRAY_LENGTH(array) (sizeof(array)/sizeof(array[0]))
+
+typedef enum {
+    S_SUCCESS = 0,
+    E_ERROR = -1,
+    E_UNKNOWN = -2,
+    E_INTERNAL = -3,
+    E_INVALID_ARGUMENT = -4,
+    E_OUT_OF_MEMORY = -5,
+    E_OUT_OF_STORAGE = -6,
+    E_OUT_OF_RESOURCES = -7,
+    E_RANGE = -8,
+    E_DOES_NOT_EXIST = -9,
+} StatusCode;
+
+size_t heap_bytes_used(void);
+
+// --------------------------------------------------------------------------
+// Math.
+// --------------------------------------------------------------------------
+
+#define TRIG_MAX_RATIO 0xffff
+#define TRIG_MAX_ANGLE 0x10000
+
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+
+// --------------------------------------------------------------------------
+// Graphics types.
+// --------------------------------------------------------------------------
+
+typedef struct GPoint {
+    int16_t x;
+    int16_t y;
+} GPoint;
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GPointZero GPoint(0, 0)
+
+typedef struct GSize {
+    int16_t w;
+    int16_t h;
+} GSize;
+#define GSize(w, h) ((GSize){(w), (h)})
+
+typedef struct GRect {
+    GPoint origin;
+    GSize size;
+} GRect;
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GRectZero GRect(0, 0, 0, 0)
+
+void grect_clip(GRect* rect_to_clip, const GRect* rect_clipper);
+bool grect_is_empty(const GRect* rect);
+
+// 2 bits per channel, alpha in the top bits.
+typedef union GColor8 {
+    uint8_t argb;
+    struct {
+        uint8_t b:2;
+        uint8_t g:2;
+        uint8_t r:2;
+        uint8_t a:2;
+    };
+} GColor8;
+typedef GColor8 GColor;
+
+#define GColorClear ((GColor8){.argb=0x00})
+#define GColorBlack ((GColor8){.argb=0xc0})
+#define GColorDarkGray ((GColor8){.argb=0xd5})
+#define GColorLightGray ((GColor8){.argb=0xea})
+#define GColorWhite ((GColor8){.argb=0xff})
+
+bool gcolor_equal(GColor8 x, GColor8 y);
+
+typedef enum {
+    GBitmapFormat1Bit = 0,
+    GBitmapFormat8Bit,
+    GBitmapFormat1BitPalette,
+    GBitmapFormat2BitPalette,
+    GBitmapFormat4BitPalette,
+    GBitmapFormat8BitCircular,
+} GBitmapFormat;
+
+typedef struct GBitmap GBitmap;
+
+typedef struct {
+    uint8_t* data;
+    int16_t min_x;
+    int16_t max_x;
+} GBitmapDataRowInfo;
+
+GBitmap* gbitmap_create_blank(GSize size, GBitmapFormat format);
+GBitmap* gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format, GColor* palette, bool free_on_destroy);
+GBitmap* gbitmap_create_as_sub_bitmap(const GBitmap* base_bitmap, GRect sub_rect);
+GBitmap* gbitmap_create_with_resource(uint32_t resource_id);
+void gbitmap_destroy(GBitmap* bitmap);
+uint8_t* gbitmap_get_data(const GBitmap* bitmap);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap* bitmap);
+GBitmapFormat gbitmap_get_format(const GBitmap* bitmap);
+GRect gbitmap_get_bounds(const GBitmap* bitmap);
+void gbitmap_set_bounds(GBitmap* bitmap, GRect bounds);
+GColor* gbitmap_get_palette(const GBitmap* bitmap);
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap* bitmap, uint16_t y);
+
+// --------------------------------------------------------------------------
+// Drawing.
+// --------------------------------------------------------------------------
+
+typedef struct GContext GContext;
+
+typedef enum {
+    GCompOpAssign,
+    GCompOpAssignInverted,
+    GCompOpOr,
+    GCompOpAnd,
+    GCompOpClear,
+    GCompOpSet,
+} GCompOp;
+
+typedef enum {
+    GCornerNone = 0,
+    GCornerTopLeft = 1 << 0,
+    GCornerTopRight = 1 << 1,
+    GCornerBottomLeft = 1 << 2,
+    GCornerBottomRight = 1 << 3,
+    GCornersAll = 0xf,
+} GCornerMask;
+
+void graphics_context_set_stroke_color(GContext* ctx, GColor color);
+void graphics_context_set_fill_color(GContext* ctx, GColor color);
+void graphics_context_set_text_color(GContext* ctx, GColor color);
+void graphics_context_set_compositing_mode(GContext* ctx, GCompOp mode);
+void graphics_draw_pixel(GContext* ctx, GPoint point);
+void graphics_draw_line(GContext* ctx, GPoint p0, GPoint p1);
+void graphics_draw_rect(GContext* ctx, GRect rect);
+void graphics_fill_rect(GContext* ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void graphics_draw_bitmap_in_rect(GContext* ctx, const GBitmap* bitmap, GRect rect);
+GBitmap* graphics_capture_frame_buffer(GContext* ctx);
+bool graphics_release_frame_buffer(GContext* ctx, GBitmap* buffer);
+
+// --------------------------------------------------------------------------
+// Fonts and text.
+// --------------------------------------------------------------------------
+
+typedef const struct HostFont* GFont;
+
+#define FONT_KEY_GOTHIC_14 "RESOURCE_ID_GOTHIC_14"
+#define FONT_KEY_GOTHIC_14_BOLD "RESOURCE_ID_GOTHIC_14_BOLD"
+#define FONT_KEY_GOTHIC_18_BOLD "RESOURCE_ID_GOTHIC_18_BOLD"
+
+GFont fonts_get_system_font(const char* font_key);
+
+typedef enum {
+    GTextOverflowModeWordWrap,
+    GTextOverflowModeTrailingEllipsis,
+    GTextOverflowModeFill,
+} GTextOverflowMode;
+
+typedef enum {
+    GTextAlignmentLeft,
+    GTextAlignmentCenter,
+    GTextAlignmentRight,
+} GTextAlignment;
+
+typedef struct GTextAttributes GTextAttributes;
+
+void graphics_draw_text(GContext* ctx, const char* text, GFont font, GRect box,
+                        GTextOverflowMode overflow_mode, GTextAlignment alignment, GTextAttributes* text_attributes);
+
+// --------------------------------------------------------------------------
+// Resources.
+// --------------------------------------------------------------------------
+
+// The SDK generates these from package.json.
+#define RESOURCE_ID_WEATHER_ICONS_25 1
+
+// --------------------------------------------------------------------------
+// Layers and windows.
+// --------------------------------------------------------------------------
+
+typedef struct Layer Layer;
+typedef void (*LayerUpdateProc)(Layer* layer, GContext* ctx);
+
+Layer* layer_create(GRect frame);
+void layer_destroy(Layer* layer);
+void layer_mark_dirty(Layer* layer);
+void layer_set_update_proc(Layer* layer, LayerUpdateProc update_proc);
+GRect layer_get_frame(const Layer* layer);
+GRect layer_get_bounds(const Layer* layer);
+void layer_add_child(Layer* parent, Layer* child);
+
+typedef struct Window Window;
+typedef void (*WindowHandler)(Window* window);
+
+typedef struct WindowHandlers {
+    WindowHandler load;
+    WindowHandler appear;
+    WindowHandler disappear;
+    WindowHandler unload;
+} WindowHandlers;
+
+Window* window_create(void);
+void window_destroy(Window* window);
+void window_set_background_color(Window* window, GColor background_color);
+void window_set_window_handlers(Window* window, WindowHandlers handlers);
+Layer* window_get_root_layer(const Window* window);
+void window_stack_push(Window* window, bool animated);
+
+void app_event_loop(void);
+
+// --------------------------------------------------------------------------
+// Timers.
+// --------------------------------------------------------------------------
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void* data);
+
+AppTimer* app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void* callback_data);
+void app_timer_cancel(AppTimer* timer_handle);
+
+// --------------------------------------------------------------------------
+// Event services.
+// --------------------------------------------------------------------------
+
+typedef enum {
+    SECOND_UNIT = 1 << 0,
+    MINUTE_UNIT = 1 << 1,
+    HOUR_UNIT = 1 << 2,
+    DAY_UNIT = 1 << 3,
+    MONTH_UNIT = 1 << 4,
+    YEAR_UNIT = 1 << 5,
+} TimeUnits;
+
+typedef void (*TickHandler)(struct tm* tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+
+typedef struct {
+    uint8_t charge_percent;
+    bool is_charging;
+    bool is_plugged;
+} BatteryChargeState;
+
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
+BatteryChargeState battery_state_service_peek(void);
+
+typedef void (*ConnectionHandler)(bool connected);
+typedef struct {
+    ConnectionHandler pebble_app_connection_handler;
+    ConnectionHandler pebblekit_connection_handler;
+} ConnectionHandlers;
+
+void connection_service_subscribe(ConnectionHandlers conn_handlers);
+void connection_service_unsubscribe(void);
+bool connection_service_peek_pebble_app_connection(void);
+
+typedef enum {
+    ACCEL_AXIS_X = 0,
+    ACCEL_AXIS_Y = 1,
+    ACCEL_AXIS_Z = 2,
+} AccelAxisType;
+
+typedef void (*AccelTapHandler)(AccelAxisType axis, int32_t direction);
+void accel_tap_service_subscribe(AccelTapHandler handler);
+void accel_tap_service_unsubscribe(void);
+
+// --------------------------------------------------------------------------
+// Health.
+// --------------------------------------------------------------------------
+
+typedef int32_t HealthValue;
+
+typedef enum {
+    HealthMetricStepCount,
+    HealthMetricActiveSeconds,
+    HealthMetricWalkedDistanceMeters,
+    HealthMetricSleepSeconds,
+    HealthMetricSleepRestfulSeconds,
+    HealthMetricRestingKCalories,
+    HealthMetricActiveKCalories,
+    HealthMetricHeartRateBPM,
+    HealthMetricHeartRateRawBPM,
+} HealthMetric;
+
+typedef enum {
+    HealthActivityNone = 0,
+    HealthActivitySleep = 1 << 0,
+    HealthActivityRestfulSleep = 1 << 1,
+    HealthActivityWalk = 1 << 2,
+    HealthActivityRun = 1 << 3,
+    HealthActivityOpenWorkout = 1 << 4,
+} HealthActivity;
+typedef uint32_t HealthActivityMask;
+
+typedef enum {
+    HealthServiceAccessibilityMaskAvailable = 1 << 0,
+    HealthServiceAccessibilityMaskNoPermission = 1 << 1,
+    HealthServiceAccessibilityMaskNotSupported = 1 << 2,
+    HealthServiceAccessibilityMaskNotAvailable = 1 << 3,
+} HealthServiceAccessibilityMask;
+
+typedef enum {
+    HealthEventSignificantUpdate = 0,
+    HealthEventMovementUpdate,
+    HealthEventSleepUpdate,
+    HealthEventMetricAlert,
+    HealthEventHeartRateUpdate,
+} HealthEventType;
+
+typedef struct {
+    uint8_t steps;
+    uint8_t orientation;
+    uint16_t vmc;
+    bool is_invalid:1;
+    uint8_t light:3;
+    uint8_t padding:4;
+    uint8_t heart_rate_bpm;
+    uint8_t reserved[6];
+} HealthMinuteData;
+
+typedef void (*HealthEventHandler)(HealthEventType event, void* context);
+
+bool health_service_events_subscribe(HealthEventHandler handler, void* context);
+bool health_service_events_unsubscribe(void);
+HealthValue health_service_sum_today(HealthMetric metric);
+HealthValue health_service_peek_current_value(HealthMetric metric);
+HealthActivityMask health_service_peek_current_activities(void);
+HealthServiceAccessibilityMask health_service_metric_accessible(HealthMetric metric, time_t time_start, time_t time_end);
+uint32_t health_service_get_minute_history(HealthMinuteData* minute_data, uint32_t max_records,
+                                           time_t* time_start, time_t* time_end);
+
+// --------------------------------------------------------------------------
+// Dictionaries and AppMessage.
+// --------------------------------------------------------------------------
+
+typedef enum {
+    TUPLE_BYTE_ARRAY = 0,
+    TUPLE_CSTRING = 1,
+    TUPLE_UINT = 2,
+    TUPLE_INT = 3,
+} TupleType;
+
+// Laid out as on the wire, so `dict_size` counts real message bytes.
+typedef struct __attribute__((__packed__)) {
+    uint32_t key;
+    TupleType type:8;
+    uint16_t length;
+    union {
+        uint8_t data[0];
+        char cstring[0];
+        uint8_t uint8;
+        uint16_t uint16;
+        uint32_t uint32;
+        int8_t int8;
+        int16_t int16;
+        int32_t int32;
+    } value[];
+} Tuple;
+
+typedef struct {
+    uint8_t* begin;   // The count byte.
+    uint8_t* end;     // Past the last tuple.
+    uint8_t* limit;   // Past the buffer - writes stop there.
+    Tuple* cursor;
+} DictionaryIterator;
+
+typedef enum {
+    DICT_OK = 0,
+    DICT_NOT_ENOUGH_STORAGE = 1 << 1,
+    DICT_INVALID_ARGS = 1 << 2,
+} DictionaryResult;
+
+Tuple* dict_read_first(DictionaryIterator* iter);
+Tuple* dict_read_next(DictionaryIterator* iter);
+uint32_t dict_size(DictionaryIterator* iter);
+DictionaryResult dict_write_data(DictionaryIterator* iter, const uint32_t key, const uint8_t* data, const uint16_t size);
+DictionaryResult dict_write_uint8(DictionaryIterator* iter, const uint32_t key, const uint8_t value);
+DictionaryResult dict_write_int32(DictionaryIterator* iter, const uint32_t key, const int32_t value);
+
+typedef enum {
+    APP_MSG_OK = 0,
+    APP_MSG_SEND_TIMEOUT = 1 << 1,
+    APP_MSG_SEND_REJECTED = 1 << 2,
+    APP_MSG_NOT_CONNECTED = 1 << 3,
+    APP_MSG_APP_NOT_RUNNING = 1 << 4,
+    APP_MSG_INVALID_ARGS = 1 << 5,
+    APP_MSG_BUSY = 1 << 6,
+    APP_MSG_BUFFER_OVERFLOW = 1 << 7,
+    APP_MSG_OUT_OF_MEMORY = 1 << 12,
+    APP_MSG_CLOSED = 1 << 13,
+    APP_MSG_INTERNAL_ERROR = 1 << 14,
+    APP_MSG_INVALID_STATE = 1 << 15,
+} AppMessageResult;
+
+typedef void (*AppMessageInboxReceived)(DictionaryIterator* iterator, void* context);
+typedef void (*AppMessageInboxDropped)(AppMessageResult reason, void* context);
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound);
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback);
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback);
+void app_message_deregister_callbacks(void);
+AppMessageResult app_message_outbox_begin(DictionaryIterator** iterator);
+AppMessageResult app_message_outbox_send(void);
+
+// --------------------------------------------------------------------------
+// Persistent storage.
+// --------------------------------------------------------------------------
+
+int persist_read_data(const uint32_t key, void* buffer, const size_t buffer_size);
+int persist_write_data(const uint32_t key, const void* data, const size_t size);
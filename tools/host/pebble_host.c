@@ -0,0 +1,1356 @@
+// Implementations behind the stand-in pebble.h: a simulated clock and event services, an in-memory frame
+// buffer with the drawing primitives watchface.c uses, dictionaries, AppMessage and persistent storage.
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+#include "host.h"
+#include "resources.h"
+
+HostCounters host_counters;
+void (*host_outbox_hook)(DictionaryIterator* iter);
+bool host_verbose;
+
+// --------------------------------------------------------------------------
+// Heap accounting.
+// --------------------------------------------------------------------------
+
+// Everything the watchface allocates through the SDK goes through here, so `heap_bytes_used` means the
+// same as on the watch, minus the allocator's own overhead.
+static size_t s_heap_used;
+
+typedef union {
+    size_t size;
+    max_align_t align;
+} HeapHeader;
+
+static void* heap_alloc(size_t size) {
+    HeapHeader* header = calloc(1, sizeof(HeapHeader) + size);
+    if (!header) {
+        return NULL;
+    }
+    header->size = size;
+    s_heap_used += size;
+    return header + 1;
+}
+
+static void heap_free(void* p) {
+    if (!p) {
+        return;
+    }
+    HeapHeader* header = (HeapHeader*)p - 1;
+    s_heap_used -= header->size;
+    free(header);
+}
+
+size_t heap_bytes_used(void) {
+    return s_heap_used;
+}
+
+// --------------------------------------------------------------------------
+// Time and logging.
+// --------------------------------------------------------------------------
+
+static int64_t s_now_ms;
+
+time_t host_time(time_t* t) {
+    time_t now = s_now_ms / 1000;
+    if (t) {
+        *t = now;
+    }
+    return now;
+}
+
+static uint64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint16_t time_ms(time_t* t, uint16_t* ms) {
+    uint64_t now_ms = monotonic_us() / 1000;
+    if (t) {
+        *t = now_ms / 1000;
+    }
+    if (ms) {
+        *ms = now_ms % 1000;
+    }
+    return now_ms % 1000;
+}
+
+void app_log(uint8_t log_level, const char* src_filename, int src_line_number, const char* fmt, ...) {
+    if (!host_verbose) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "[%d] %s:%d ", log_level, src_filename, src_line_number);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+// --------------------------------------------------------------------------
+// Math.
+// --------------------------------------------------------------------------
+
+int32_t sin_lookup(int32_t angle) {
+    return (int32_t)lround(sin(2 * M_PI * angle / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+    return (int32_t)lround(cos(2 * M_PI * angle / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+// --------------------------------------------------------------------------
+// Geometry and colors.
+// --------------------------------------------------------------------------
+
+void grect_clip(GRect* rect_to_clip, const GRect* rect_clipper) {
+    int x0 = rect_to_clip->origin.x > rect_clipper->origin.x ? rect_to_clip->origin.x : rect_clipper->origin.x;
+    int y0 = rect_to_clip->origin.y > rect_clipper->origin.y ? rect_to_clip->origin.y : rect_clipper->origin.y;
+    int x1 = rect_to_clip->origin.x + rect_to_clip->size.w;
+    int y1 = rect_to_clip->origin.y + rect_to_clip->size.h;
+    int cx1 = rect_clipper->origin.x + rect_clipper->size.w;
+    int cy1 = rect_clipper->origin.y + rect_clipper->size.h;
+    x1 = x1 < cx1 ? x1 : cx1;
+    y1 = y1 < cy1 ? y1 : cy1;
+    *rect_to_clip = GRect(x0, y0, x1 > x0 ? x1 - x0 : 0, y1 > y0 ? y1 - y0 : 0);
+}
+
+bool grect_is_empty(const GRect* rect) {
+    return rect->size.w <= 0 || rect->size.h <= 0;
+}
+
+bool gcolor_equal(GColor8 x, GColor8 y) {
+    return x.argb == y.argb;
+}
+
+// --------------------------------------------------------------------------
+// Bitmaps.
+// --------------------------------------------------------------------------
+
+struct GBitmap {
+    uint8_t* data;
+    uint16_t row_size;
+    GBitmapFormat format;
+    GRect bounds;          // Within `data`; sub-bitmaps share their parent's data.
+    GColor* palette;
+    bool owns_data;
+    bool owns_palette;
+};
+
+static int format_bits(GBitmapFormat format) {
+    switch (format) {
+        case GBitmapFormat1Bit:
+        case GBitmapFormat1BitPalette:
+            return 1;
+        case GBitmapFormat2BitPalette:
+            return 2;
+        case GBitmapFormat4BitPalette:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+static uint16_t format_row_size(GBitmapFormat format, int width) {
+    if (format == GBitmapFormat1Bit) { // Word aligned, like the black and white frame buffer.
+        return (width + 31) / 32 * 4;
+    }
+    return (width * format_bits(format) + 7) / 8;
+}
+
+GBitmap* gbitmap_create_blank(GSize size, GBitmapFormat format) {
+    if (format_bits(format) < 8 && format != GBitmapFormat1Bit) {
+        return NULL; // Palettized bitmaps need a palette.
+    }
+    GBitmap* bitmap = heap_alloc(sizeof(GBitmap));
+    if (!bitmap) {
+        return NULL;
+    }
+    bitmap->row_size = format_row_size(format, size.w);
+    bitmap->data = heap_alloc((size_t)bitmap->row_size * size.h);
+    if (!bitmap->data) {
+        heap_free(bitmap);
+        return NULL;
+    }
+    bitmap->format = format;
+    bitmap->bounds = GRect(0, 0, size.w, size.h);
+    bitmap->owns_data = true;
+    return bitmap;
+}
+
+GBitmap* gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format, GColor* palette, bool free_on_destroy) {
+    if (format_bits(format) >= 8 || format == GBitmapFormat1Bit) {
+        return NULL;
+    }
+    GBitmap* bitmap = heap_alloc(sizeof(GBitmap));
+    if (!bitmap) {
+        return NULL;
+    }
+    bitmap->row_size = format_row_size(format, size.w);
+    bitmap->data = heap_alloc((size_t)bitmap->row_size * size.h);
+    if (!bitmap->data) {
+        heap_free(bitmap);
+        return NULL;
+    }
+    bitmap->format = format;
+    bitmap->bounds = GRect(0, 0, size.w, size.h);
+    bitmap->palette = palette;
+    bitmap->owns_data = true;
+    bitmap->owns_palette = free_on_destroy;
+    return bitmap;
+}
+
+GBitmap* gbitmap_create_as_sub_bitmap(const GBitmap* base_bitmap, GRect sub_rect) {
+    GBitmap* bitmap = heap_alloc(sizeof(GBitmap));
+    if (!bitmap) {
+        return NULL;
+    }
+    *bitmap = *base_bitmap;
+    sub_rect.origin.x += base_bitmap->bounds.origin.x;
+    sub_rect.origin.y += base_bitmap->bounds.origin.y;
+    grect_clip(&sub_rect, &base_bitmap->bounds);
+    bitmap->bounds = sub_rect;
+    bitmap->owns_data = false;
+    bitmap->owns_palette = false;
+    return bitmap;
+}
+
+GBitmap* gbitmap_create_with_resource(uint32_t resource_id) {
+    for (size_t i = 0; i < ARRAY_LENGTH(HOST_RESOURCES); i++) {
+        const HostResource* resource = &HOST_RESOURCES[i];
+        if (resource->id != resource_id) {
+            continue;
+        }
+        // The SDK converts images for the platform at build time; color platforms get them as 8 bit.
+        GBitmap* bitmap = gbitmap_create_blank(GSize(resource->width, resource->height), GBitmapFormat8Bit);
+        if (bitmap) {
+            memcpy(bitmap->data, resource->pixels, (size_t)resource->width * resource->height);
+        }
+        return bitmap;
+    }
+    return NULL;
+}
+
+void gbitmap_destroy(GBitmap* bitmap) {
+    if (!bitmap) {
+        return;
+    }
+    if (bitmap->owns_data) {
+        heap_free(bitmap->data);
+    }
+    if (bitmap->owns_palette) {
+        heap_free(bitmap->palette);
+    }
+    heap_free(bitmap);
+}
+
+uint8_t* gbitmap_get_data(const GBitmap* bitmap) {
+    return bitmap->data;
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap* bitmap) {
+    return bitmap->row_size;
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap* bitmap) {
+    return bitmap->format;
+}
+
+GRect gbitmap_get_bounds(const GBitmap* bitmap) {
+    return bitmap->bounds;
+}
+
+void gbitmap_set_bounds(GBitmap* bitmap, GRect bounds) {
+    bitmap->bounds = bounds;
+}
+
+GColor* gbitmap_get_palette(const GBitmap* bitmap) {
+    return bitmap->palette;
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap* bitmap, uint16_t y) {
+    return (GBitmapDataRowInfo){
+        .data = bitmap->data + (size_t)y * bitmap->row_size,
+        .min_x = bitmap->bounds.origin.x,
+        .max_x = bitmap->bounds.origin.x + bitmap->bounds.size.w - 1,
+    };
+}
+
+// Pixel at data coordinates. 1 bit bitmaps hold the leftmost pixel in the lowest bit, palettized ones in
+// the highest bits, as on the watch.
+static GColor bitmap_pixel(const GBitmap* bitmap, int x, int y) {
+    const uint8_t* row = bitmap->data + (size_t)y * bitmap->row_size;
+    if (bitmap->format == GBitmapFormat1Bit) {
+        return (row[x / 8] >> (x % 8)) & 1 ? GColorWhite : GColorBlack;
+    }
+    int bits = format_bits(bitmap->format);
+    if (bits == 8) {
+        return (GColor){.argb = row[x]};
+    }
+    int per_byte = 8 / bits;
+    int shift = 8 - bits * (x % per_byte + 1);
+    return bitmap->palette[(row[x / per_byte] >> shift) & ((1 << bits) - 1)];
+}
+
+// --------------------------------------------------------------------------
+// Frame buffer.
+// --------------------------------------------------------------------------
+
+static uint8_t s_fb_data[PBL_DISPLAY_HEIGHT * (PBL_IF_BW_ELSE((PBL_DISPLAY_WIDTH + 31) / 32 * 4, PBL_DISPLAY_WIDTH))];
+static GBitmap s_fb = {
+    .data = s_fb_data,
+    .row_size = PBL_IF_BW_ELSE((PBL_DISPLAY_WIDTH + 31) / 32 * 4, PBL_DISPLAY_WIDTH),
+    .format = PBL_IF_BW_ELSE(GBitmapFormat1Bit, GBitmapFormat8Bit),
+    .bounds = {{0, 0}, {PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT}},
+};
+
+GBitmap* host_frame_buffer(void) {
+    return &s_fb;
+}
+
+// Black and white screens show anything but black and white as a 50% checkerboard, like fb_fill_span.
+static void fb_put(int x, int y, GColor color) {
+#if defined(PBL_BW)
+    uint8_t* byte = &s_fb.data[y * s_fb.row_size + x / 8];
+    bool white = gcolor_equal(color, GColorWhite) || (!gcolor_equal(color, GColorBlack) && ((x + y) & 1));
+    if (white) {
+        *byte |= 1 << (x % 8);
+    } else {
+        *byte &= ~(1 << (x % 8));
+    }
+#else
+    s_fb.data[y * s_fb.row_size + x] = color.argb | 0xc0;
+#endif
+}
+
+GColor host_frame_pixel(int x, int y) {
+    return bitmap_pixel(&s_fb, x, y);
+}
+
+// --------------------------------------------------------------------------
+// Graphics context and primitives.
+// --------------------------------------------------------------------------
+
+struct GContext {
+    GPoint offset;         // Of the layer being drawn, in screen coordinates.
+    GRect clip;            // In screen coordinates.
+    GColor stroke_color;
+    GColor fill_color;
+    GColor text_color;
+    GCompOp compositing_mode;
+    bool captured;
+    uint8_t captured_copy[sizeof s_fb_data];
+};
+
+static GContext s_ctx;
+
+static void context_reset(GRect frame) {
+    s_ctx.offset = frame.origin;
+    s_ctx.clip = frame;
+    grect_clip(&s_ctx.clip, &s_fb.bounds);
+    s_ctx.stroke_color = GColorBlack;
+    s_ctx.fill_color = GColorBlack;
+    s_ctx.text_color = GColorBlack;
+    s_ctx.compositing_mode = GCompOpAssign;
+}
+
+GContext* host_graphics_context(void) {
+    context_reset(s_fb.bounds);
+    return &s_ctx;
+}
+
+static bool clipped(const GContext* ctx, int x, int y) {
+    return x < ctx->clip.origin.x || y < ctx->clip.origin.y ||
+           x >= ctx->clip.origin.x + ctx->clip.size.w || y >= ctx->clip.origin.y + ctx->clip.size.h;
+}
+
+// Pixel in layer coordinates, counted.
+static void ctx_put(GContext* ctx, int x, int y, GColor color) {
+    x += ctx->offset.x;
+    y += ctx->offset.y;
+    if (color.a == 0 || clipped(ctx, x, y)) {
+        return;
+    }
+    fb_put(x, y, color);
+    host_counters.pixels += 1;
+}
+
+void host_cover_pixel(GContext* ctx, int x, int y, GColor color, int coverage) {
+#if defined(PBL_BW)
+    if (coverage >= 128) {
+        ctx_put(ctx, x, y, color);
+    }
+#else
+    int sx = x + ctx->offset.x;
+    int sy = y + ctx->offset.y;
+    if (coverage <= 0 || clipped(ctx, sx, sy)) {
+        return;
+    }
+    GColor dst = host_frame_pixel(sx, sy);
+    int a = coverage > 256 ? 256 : coverage;
+    GColor mixed = {
+        .r = (color.r * a + dst.r * (256 - a) + 128) / 256,
+        .g = (color.g * a + dst.g * (256 - a) + 128) / 256,
+        .b = (color.b * a + dst.b * (256 - a) + 128) / 256,
+        .a = 3,
+    };
+    ctx_put(ctx, x, y, mixed);
+#endif
+}
+
+void graphics_context_set_stroke_color(GContext* ctx, GColor color) {
+    ctx->stroke_color = color;
+}
+
+void graphics_context_set_fill_color(GContext* ctx, GColor color) {
+    ctx->fill_color = color;
+}
+
+void graphics_context_set_text_color(GContext* ctx, GColor color) {
+    ctx->text_color = color;
+}
+
+void graphics_context_set_compositing_mode(GContext* ctx, GCompOp mode) {
+    ctx->compositing_mode = mode;
+}
+
+void graphics_draw_pixel(GContext* ctx, GPoint point) {
+    host_counters.primitives += 1;
+    ctx_put(ctx, point.x, point.y, ctx->stroke_color);
+}
+
+void graphics_draw_line(GContext* ctx, GPoint p0, GPoint p1) {
+    host_counters.primitives += 1;
+    int dx = abs(p1.x - p0.x);
+    int dy = -abs(p1.y - p0.y);
+    int sx = p0.x < p1.x ? 1 : -1;
+    int sy = p0.y < p1.y ? 1 : -1;
+    int err = dx + dy;
+    int x = p0.x;
+    int y = p0.y;
+    for (;;) {
+        ctx_put(ctx, x, y, ctx->stroke_color);
+        if (x == p1.x && y == p1.y) {
+            break;
+        }
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+void graphics_draw_rect(GContext* ctx, GRect rect) {
+    host_counters.primitives += 1;
+    int x0 = rect.origin.x;
+    int y0 = rect.origin.y;
+    int x1 = x0 + rect.size.w - 1;
+    int y1 = y0 + rect.size.h - 1;
+    for (int x = x0; x <= x1; x++) {
+        ctx_put(ctx, x, y0, ctx->stroke_color);
+        if (y1 != y0) {
+            ctx_put(ctx, x, y1, ctx->stroke_color);
+        }
+    }
+    for (int y = y0 + 1; y < y1; y++) {
+        ctx_put(ctx, x0, y, ctx->stroke_color);
+        if (x1 != x0) {
+            ctx_put(ctx, x1, y, ctx->stroke_color);
+        }
+    }
+}
+
+// Corners are not rounded - watchface.c only fills square rects.
+void graphics_fill_rect(GContext* ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask) {
+    host_counters.primitives += 1;
+    for (int y = rect.origin.y; y < rect.origin.y + rect.size.h; y++) {
+        for (int x = rect.origin.x; x < rect.origin.x + rect.size.w; x++) {
+            ctx_put(ctx, x, y, ctx->fill_color);
+        }
+    }
+}
+
+#if defined(PBL_BW)
+// Sum of the color channels, 0 (black) to 9 (white).
+static int color_luminance(GColor color) {
+    return color.r + color.g + color.b;
+}
+#else
+static GColor blend(GColor src, GColor dst) {
+    int a = src.a;
+    return (GColor){
+        .r = (src.r * a + dst.r * (3 - a) + 1) / 3,
+        .g = (src.g * a + dst.g * (3 - a) + 1) / 3,
+        .b = (src.b * a + dst.b * (3 - a) + 1) / 3,
+        .a = 3,
+    };
+}
+#endif
+
+// The bitmap is tiled over `rect`. GCompOpSet blends by alpha; black and white screens get the bitmap's
+// pixels thresholded, like the SDK's build time conversion of images does.
+void graphics_draw_bitmap_in_rect(GContext* ctx, const GBitmap* bitmap, GRect rect) {
+    host_counters.primitives += 1;
+    GRect src = bitmap->bounds;
+    if (grect_is_empty(&src)) {
+        return;
+    }
+    for (int y = 0; y < rect.size.h; y++) {
+        for (int x = 0; x < rect.size.w; x++) {
+            GColor color = bitmap_pixel(bitmap, src.origin.x + x % src.size.w, src.origin.y + y % src.size.h);
+            int sx = ctx->offset.x + rect.origin.x + x;
+            int sy = ctx->offset.y + rect.origin.y + y;
+            if (clipped(ctx, sx, sy)) {
+                continue;
+            }
+            if (ctx->compositing_mode == GCompOpSet) {
+                if (color.a == 0) {
+                    continue;
+                }
+#if defined(PBL_BW)
+                if (color.a < 2) {
+                    continue;
+                }
+#else
+                color = blend(color, host_frame_pixel(sx, sy));
+#endif
+            }
+#if defined(PBL_BW)
+            color = color_luminance(color) >= 5 ? GColorWhite : GColorBlack;
+#endif
+            color.a = 3;
+            fb_put(sx, sy, color);
+            host_counters.pixels += 1;
+        }
+    }
+}
+
+GBitmap* graphics_capture_frame_buffer(GContext* ctx) {
+    if (ctx->captured) {
+        return NULL;
+    }
+    host_counters.primitives += 1;
+    ctx->captured = true;
+    memcpy(ctx->captured_copy, s_fb_data, sizeof s_fb_data);
+    return &s_fb;
+}
+
+bool graphics_release_frame_buffer(GContext* ctx, GBitmap* buffer) {
+    if (!ctx->captured || buffer != &s_fb) {
+        return false;
+    }
+    ctx->captured = false;
+    for (int y = 0; y < s_fb.bounds.size.h; y++) {
+        for (int x = 0; x < s_fb.bounds.size.w; x++) {
+            uint8_t* row = ctx->captured_copy + y * s_fb.row_size;
+            GColor before = PBL_IF_BW_ELSE(((row[x / 8] >> (x % 8)) & 1 ? GColorWhite : GColorBlack),
+                                           ((GColor){.argb = row[x]}));
+            host_counters.pixels += !gcolor_equal(before, host_frame_pixel(x, y));
+        }
+    }
+    return true;
+}
+
+// --------------------------------------------------------------------------
+// Text.
+// --------------------------------------------------------------------------
+
+// There are no system fonts on the host. Glyphs are placeholders with roughly the metrics of the real fonts:
+// a box per character with a pattern derived from its code, so different texts give different images.
+struct HostFont {
+    const char* key;
+    uint8_t advance;
+    uint8_t width;
+    uint8_t height;
+    uint8_t top;       // Distance from the top of the text box to the top of the glyphs.
+};
+
+static const struct HostFont s_fonts[] = {
+    {FONT_KEY_GOTHIC_14, 6, 5, 7, 5},
+    {FONT_KEY_GOTHIC_14_BOLD, 7, 6, 7, 5},
+    {FONT_KEY_GOTHIC_18_BOLD, 8, 7, 9, 6},
+};
+
+GFont fonts_get_system_font(const char* font_key) {
+    for (size_t i = 0; i < ARRAY_LENGTH(s_fonts); i++) {
+        if (strcmp(s_fonts[i].key, font_key) == 0) {
+            return &s_fonts[i];
+        }
+    }
+    return &s_fonts[0];
+}
+
+// Characters in a UTF-8 text; continuation bytes do not start one.
+static int text_length(const char* text) {
+    int length = 0;
+    for (const char* p = text; *p; p++) {
+        length += ((uint8_t)*p & 0xc0) != 0x80;
+    }
+    return length;
+}
+
+// Single line only, clipped to the box.
+void graphics_draw_text(GContext* ctx, const char* text, GFont font, GRect box,
+                        GTextOverflowMode overflow_mode, GTextAlignment alignment, GTextAttributes* text_attributes) {
+    host_counters.primitives += 1;
+    int width = text_length(text) * font->advance;
+    int x = box.origin.x;
+    if (alignment == GTextAlignmentCenter) {
+        x += (box.size.w - width) / 2;
+    } else if (alignment == GTextAlignmentRight) {
+        x += box.size.w - width;
+    }
+    GRect clip = ctx->clip;
+    GRect screen_box = GRect(box.origin.x + ctx->offset.x, box.origin.y + ctx->offset.y, box.size.w, box.size.h);
+    grect_clip(&ctx->clip, &screen_box);
+    int y = box.origin.y + font->top;
+    for (const char* p = text; *p; ) {
+        uint32_t code = (uint8_t)*p++;
+        while (((uint8_t)*p & 0xc0) == 0x80) {
+            code = code << 6 | ((uint8_t)*p++ & 0x3f);
+        }
+        if (code != ' ') {
+            uint32_t pattern = code * 2654435761u;
+            for (int row = 0; row < font->height; row++) {
+                for (int col = 0; col < font->width; col++) {
+                    bool edge = row == 0 || row == font->height - 1 || col == 0 || col == font->width - 1;
+                    if (edge || (pattern >> ((row * font->width + col) % 32)) & 1) {
+                        ctx_put(ctx, x + col, y + row, ctx->text_color);
+                    }
+                }
+            }
+        }
+        x += font->advance;
+    }
+    ctx->clip = clip;
+}
+
+// --------------------------------------------------------------------------
+// Layers and windows.
+// --------------------------------------------------------------------------
+
+struct Layer {
+    GRect frame;
+    LayerUpdateProc update_proc;
+    Layer* first_child;
+    Layer* next_sibling;
+};
+
+struct Window {
+    Layer root;
+    GColor background_color;
+    WindowHandlers handlers;
+};
+
+static Window* s_top_window;
+static bool s_frame_pending;
+
+Layer* layer_create(GRect frame) {
+    Layer* layer = heap_alloc(sizeof(Layer));
+    if (layer) {
+        layer->frame = frame;
+    }
+    return layer;
+}
+
+void layer_destroy(Layer* layer) {
+    heap_free(layer);
+}
+
+void layer_mark_dirty(Layer* layer) {
+    s_frame_pending = true;
+}
+
+void layer_set_update_proc(Layer* layer, LayerUpdateProc update_proc) {
+    layer->update_proc = update_proc;
+}
+
+GRect layer_get_frame(const Layer* layer) {
+    return layer->frame;
+}
+
+GRect layer_get_bounds(const Layer* layer) {
+    return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+void layer_add_child(Layer* parent, Layer* child) {
+    Layer** link = &parent->first_child;
+    while (*link) {
+        link = &(*link)->next_sibling;
+    }
+    *link = child;
+}
+
+Window* window_create(void) {
+    Window* window = heap_alloc(sizeof(Window));
+    if (window) {
+        window->root.frame = s_fb.bounds;
+        window->background_color = GColorWhite;
+    }
+    return window;
+}
+
+void window_destroy(Window* window) {
+    if (window == s_top_window) {
+        s_top_window = NULL;
+    }
+    heap_free(window);
+}
+
+void window_set_background_color(Window* window, GColor background_color) {
+    window->background_color = background_color;
+}
+
+void window_set_window_handlers(Window* window, WindowHandlers handlers) {
+    window->handlers = handlers;
+}
+
+Layer* window_get_root_layer(const Window* window) {
+    return (Layer*)&window->root;
+}
+
+void window_stack_push(Window* window, bool animated) {
+    s_top_window = window;
+    if (window->handlers.load) {
+        window->handlers.load(window);
+    }
+    if (window->handlers.appear) {
+        window->handlers.appear(window);
+    }
+    s_frame_pending = true;
+}
+
+// The watchface drives itself through the harness instead.
+void app_event_loop(void) {
+}
+
+static void render_layer(Layer* layer, GPoint origin) {
+    origin.x += layer->frame.origin.x;
+    origin.y += layer->frame.origin.y;
+    if (layer->update_proc) {
+        context_reset(GRect(origin.x, origin.y, layer->frame.size.w, layer->frame.size.h));
+        layer->update_proc(layer, &s_ctx);
+    }
+    for (Layer* child = layer->first_child; child; child = child->next_sibling) {
+        render_layer(child, origin);
+    }
+}
+
+void host_flush(void) {
+    if (!s_frame_pending || !s_top_window) {
+        return;
+    }
+    s_frame_pending = false;
+    uint64_t start = monotonic_us();
+    if (s_top_window->background_color.a != 0) {
+        GContext* ctx = host_graphics_context();
+        graphics_context_set_fill_color(ctx, s_top_window->background_color);
+        graphics_fill_rect(ctx, s_fb.bounds, 0, GCornerNone);
+    }
+    render_layer(&s_top_window->root, GPointZero);
+    host_counters.frames += 1;
+    host_counters.frame_us += monotonic_us() - start;
+}
+
+// --------------------------------------------------------------------------
+// Timers and ticks.
+// --------------------------------------------------------------------------
+
+struct AppTimer {
+    int64_t due_ms;
+    AppTimerCallback callback;
+    void* data;
+    AppTimer* next;
+};
+
+static AppTimer* s_timers; // Sorted by due time.
+
+AppTimer* app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void* callback_data) {
+    AppTimer* timer = heap_alloc(sizeof(AppTimer));
+    if (!timer) {
+        return NULL;
+    }
+    timer->due_ms = s_now_ms + timeout_ms;
+    timer->callback = callback;
+    timer->data = callback_data;
+    AppTimer** link = &s_timers;
+    while (*link && (*link)->due_ms <= timer->due_ms) {
+        link = &(*link)->next;
+    }
+    timer->next = *link;
+    *link = timer;
+    return timer;
+}
+
+void app_timer_cancel(AppTimer* timer_handle) {
+    for (AppTimer** link = &s_timers; *link; link = &(*link)->next) {
+        if (*link == timer_handle) {
+            *link = timer_handle->next;
+            heap_free(timer_handle);
+            return;
+        }
+    }
+}
+
+static TimeUnits s_tick_units;
+static TickHandler s_tick_handler;
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+    s_tick_units = tick_units;
+    s_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+    s_tick_handler = NULL;
+}
+
+// The finest unit the subscription asks for, in seconds.
+static int tick_period(void) {
+    return s_tick_units & SECOND_UNIT ? 1 : s_tick_units & MINUTE_UNIT ? SECONDS_PER_MINUTE : SECONDS_PER_HOUR;
+}
+
+static void health_record_minutes(void);
+
+void host_set_time(time_t t) {
+    s_now_ms = (int64_t)t * 1000;
+}
+
+int64_t host_now_ms(void) {
+    return s_now_ms;
+}
+
+void host_run_until(int64_t t_ms) {
+    for (;;) {
+        int64_t next_tick = INT64_MAX;
+        if (s_tick_handler) {
+            int64_t period_ms = tick_period() * 1000;
+            next_tick = (s_now_ms / period_ms + 1) * period_ms;
+        }
+        int64_t next_timer = s_timers ? s_timers->due_ms : INT64_MAX;
+        int64_t next = next_tick < next_timer ? next_tick : next_timer;
+        if (next > t_ms) {
+            break;
+        }
+        time_t before = s_now_ms / 1000;
+        s_now_ms = next > s_now_ms ? next : s_now_ms;
+        health_record_minutes();
+        if (next_timer <= next_tick) {
+            AppTimer* timer = s_timers;
+            s_timers = timer->next;
+            AppTimerCallback callback = timer->callback;
+            void* data = timer->data;
+            heap_free(timer);
+            host_counters.wakeups += 1;
+            host_counters.timers += 1;
+            callback(data);
+        } else {
+            time_t now = s_now_ms / 1000;
+            struct tm old_time = *localtime(&before);
+            struct tm tick_time = *localtime(&now);
+            TimeUnits changed = SECOND_UNIT;
+            changed |= old_time.tm_min != tick_time.tm_min || now - before >= SECONDS_PER_MINUTE ? MINUTE_UNIT : 0;
+            changed |= old_time.tm_hour != tick_time.tm_hour || now - before >= SECONDS_PER_HOUR ? HOUR_UNIT : 0;
+            changed |= old_time.tm_mday != tick_time.tm_mday ? DAY_UNIT : 0;
+            host_counters.wakeups += 1;
+            host_counters.ticks += 1;
+            s_tick_handler(&tick_time, changed);
+        }
+        host_flush();
+    }
+    s_now_ms = t_ms > s_now_ms ? t_ms : s_now_ms;
+    health_record_minutes();
+}
+
+// --------------------------------------------------------------------------
+// Battery, connection and taps.
+// --------------------------------------------------------------------------
+
+static BatteryChargeState s_battery = {.charge_percent = 100};
+static BatteryStateHandler s_battery_handler;
+static bool s_connected = true;
+static ConnectionHandlers s_connection_handlers;
+static AccelTapHandler s_tap_handler;
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+    s_battery_handler = handler;
+}
+
+void battery_state_service_unsubscribe(void) {
+    s_battery_handler = NULL;
+}
+
+BatteryChargeState battery_state_service_peek(void) {
+    return s_battery;
+}
+
+void host_set_battery(uint8_t percent, bool charging) {
+    s_battery = (BatteryChargeState){.charge_percent = percent, .is_charging = charging, .is_plugged = charging};
+    if (s_battery_handler) {
+        host_counters.wakeups += 1;
+        host_counters.battery_events += 1;
+        s_battery_handler(s_battery);
+        host_flush();
+    }
+}
+
+void connection_service_subscribe(ConnectionHandlers conn_handlers) {
+    s_connection_handlers = conn_handlers;
+}
+
+void connection_service_unsubscribe(void) {
+    s_connection_handlers = (ConnectionHandlers){0};
+}
+
+bool connection_service_peek_pebble_app_connection(void) {
+    return s_connected;
+}
+
+void host_set_connected(bool connected) {
+    s_connected = connected;
+    if (s_connection_handlers.pebble_app_connection_handler) {
+        host_counters.wakeups += 1;
+        host_counters.connection_events += 1;
+        s_connection_handlers.pebble_app_connection_handler(connected);
+        host_flush();
+    }
+}
+
+void accel_tap_service_subscribe(AccelTapHandler handler) {
+    s_tap_handler = handler;
+}
+
+void accel_tap_service_unsubscribe(void) {
+    s_tap_handler = NULL;
+}
+
+void host_tap(void) {
+    if (s_tap_handler) {
+        host_counters.wakeups += 1;
+        host_counters.taps += 1;
+        s_tap_handler(ACCEL_AXIS_Z, 1);
+        host_flush();
+    }
+}
+
+// --------------------------------------------------------------------------
+// Health.
+// --------------------------------------------------------------------------
+
+#define HEALTH_HISTORY_MINUTES (24*60) // The minute history the service keeps.
+
+static HealthValue s_health_sums[HealthMetricHeartRateRawBPM + 1];
+static uint8_t s_health_bpm;
+static HealthActivityMask s_health_activities;
+static bool s_heart_rate_available = true;
+static uint8_t s_health_history[HEALTH_HISTORY_MINUTES]; // Per minute since the epoch, modulo the length.
+static int64_t s_health_recorded_until;                   // Minute up to which the history is written.
+static HealthEventHandler s_health_handler;
+static void* s_health_context;
+
+// Write the current heart rate into the minutes the clock passed.
+static void health_record_minutes(void) {
+    int64_t minute = s_now_ms / 1000 / SECONDS_PER_MINUTE;
+    if (s_health_recorded_until == 0 || minute - s_health_recorded_until > HEALTH_HISTORY_MINUTES) {
+        s_health_recorded_until = minute - HEALTH_HISTORY_MINUTES;
+    }
+    for (; s_health_recorded_until < minute; s_health_recorded_until++) {
+        s_health_history[s_health_recorded_until % HEALTH_HISTORY_MINUTES] = s_heart_rate_available ? s_health_bpm : 0;
+    }
+}
+
+void host_health_set_sum(HealthMetric metric, HealthValue value) {
+    s_health_sums[metric] = value;
+}
+
+void host_health_set_bpm(uint8_t bpm, bool notify) {
+    health_record_minutes();
+    s_health_bpm = bpm;
+    if (notify) {
+        host_health_event(HealthEventHeartRateUpdate);
+    }
+}
+
+void host_health_fill_history(int minutes, uint8_t (*bpm)(int minute)) {
+    health_record_minutes();
+    int64_t now_minute = s_now_ms / 1000 / SECONDS_PER_MINUTE;
+    for (int m = 1; m <= minutes && m <= HEALTH_HISTORY_MINUTES; m++) {
+        s_health_history[(now_minute - m) % HEALTH_HISTORY_MINUTES] = bpm(m);
+    }
+}
+
+void host_health_set_activities(HealthActivityMask activities) {
+    s_health_activities = activities;
+}
+
+void host_health_set_heart_rate_available(bool available) {
+    s_heart_rate_available = available;
+}
+
+void host_health_event(HealthEventType event) {
+    if (s_health_handler) {
+        host_counters.wakeups += 1;
+        host_counters.health_events += 1;
+        s_health_handler(event, s_health_context);
+        host_flush();
+    }
+}
+
+bool health_service_events_subscribe(HealthEventHandler handler, void* context) {
+    s_health_handler = handler;
+    s_health_context = context;
+    return true;
+}
+
+bool health_service_events_unsubscribe(void) {
+    s_health_handler = NULL;
+    return true;
+}
+
+HealthValue health_service_sum_today(HealthMetric metric) {
+    host_counters.health_calls += 1;
+    return s_health_sums[metric];
+}
+
+HealthValue health_service_peek_current_value(HealthMetric metric) {
+    host_counters.health_calls += 1;
+    if (metric == HealthMetricHeartRateBPM || metric == HealthMetricHeartRateRawBPM) {
+        return s_heart_rate_available ? s_health_bpm : 0;
+    }
+    return s_health_sums[metric];
+}
+
+HealthActivityMask health_service_peek_current_activities(void) {
+    host_counters.health_calls += 1;
+    return s_health_activities;
+}
+
+HealthServiceAccessibilityMask health_service_metric_accessible(HealthMetric metric, time_t time_start, time_t time_end) {
+    host_counters.health_calls += 1;
+    if ((metric == HealthMetricHeartRateBPM || metric == HealthMetricHeartRateRawBPM) && !s_heart_rate_available) {
+        return HealthServiceAccessibilityMaskNotSupported;
+    }
+    return HealthServiceAccessibilityMaskAvailable;
+}
+
+// Whole minutes from `*time_start` on, at most up to `*time_end` and the current minute.
+uint32_t health_service_get_minute_history(HealthMinuteData* minute_data, uint32_t max_records,
+                                           time_t* time_start, time_t* time_end) {
+    host_counters.health_calls += 1;
+    health_record_minutes();
+    int64_t now_minute = s_now_ms / 1000 / SECONDS_PER_MINUTE;
+    int64_t first = *time_start / SECONDS_PER_MINUTE;
+    int64_t end = (*time_end + SECONDS_PER_MINUTE - 1) / SECONDS_PER_MINUTE;
+    first = first > now_minute - HEALTH_HISTORY_MINUTES ? first : now_minute - HEALTH_HISTORY_MINUTES;
+    end = end < now_minute ? end : now_minute;
+    uint32_t count = 0;
+    for (int64_t m = first; m < end && count < max_records; m++, count++) {
+        uint8_t bpm = s_health_history[m % HEALTH_HISTORY_MINUTES];
+        minute_data[count] = (HealthMinuteData){.heart_rate_bpm = bpm, .is_invalid = bpm == 0};
+    }
+    *time_start = first * SECONDS_PER_MINUTE;
+    *time_end = (first + count) * SECONDS_PER_MINUTE;
+    return count;
+}
+
+// --------------------------------------------------------------------------
+// Dictionaries.
+// --------------------------------------------------------------------------
+
+Tuple* dict_read_first(DictionaryIterator* iter) {
+    iter->cursor = (Tuple*)(iter->begin + 1);
+    return iter->begin[0] ? iter->cursor : NULL;
+}
+
+Tuple* dict_read_next(DictionaryIterator* iter) {
+    uint8_t* next = (uint8_t*)iter->cursor + sizeof(Tuple) + iter->cursor->length;
+    if (next >= iter->end) {
+        return NULL;
+    }
+    iter->cursor = (Tuple*)next;
+    return iter->cursor;
+}
+
+uint32_t dict_size(DictionaryIterator* iter) {
+    return iter->end - iter->begin;
+}
+
+static DictionaryResult dict_write(DictionaryIterator* iter, uint32_t key, TupleType type, const void* data, uint16_t size) {
+    if (iter->end + sizeof(Tuple) + size > iter->limit) {
+        return DICT_NOT_ENOUGH_STORAGE;
+    }
+    Tuple* tuple = (Tuple*)iter->end;
+    tuple->key = key;
+    tuple->type = type;
+    tuple->length = size;
+    memcpy(tuple->value->data, data, size);
+    iter->end += sizeof(Tuple) + size;
+    iter->begin[0] += 1;
+    return DICT_OK;
+}
+
+DictionaryResult dict_write_data(DictionaryIterator* iter, const uint32_t key, const uint8_t* data, const uint16_t size) {
+    return dict_write(iter, key, TUPLE_BYTE_ARRAY, data, size);
+}
+
+DictionaryResult dict_write_uint8(DictionaryIterator* iter, const uint32_t key, const uint8_t value) {
+    return dict_write(iter, key, TUPLE_UINT, &value, sizeof value);
+}
+
+DictionaryResult dict_write_int32(DictionaryIterator* iter, const uint32_t key, const int32_t value) {
+    return dict_write(iter, key, TUPLE_INT, &value, sizeof value);
+}
+
+// --------------------------------------------------------------------------
+// AppMessage.
+// --------------------------------------------------------------------------
+
+// The phone side acknowledges every message at once, so the outbox is never busy between events.
+static bool s_message_open;
+static uint32_t s_inbox_size;
+static uint8_t* s_outbox;
+static uint32_t s_outbox_size;
+static DictionaryIterator s_outbox_iter;
+static bool s_outbox_pending;
+static AppMessageInboxReceived s_inbox_received;
+static AppMessageInboxDropped s_inbox_dropped;
+static uint8_t s_inbox[8192];
+static DictionaryIterator s_inbox_iter;
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound) {
+    if (s_message_open) {
+        return APP_MSG_INVALID_STATE;
+    }
+    s_outbox = heap_alloc(size_outbound);
+    if (!s_outbox) {
+        return APP_MSG_OUT_OF_MEMORY;
+    }
+    s_outbox_size = size_outbound;
+    s_inbox_size = size_inbound;
+    s_message_open = true;
+    return APP_MSG_OK;
+}
+
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback) {
+    AppMessageInboxReceived old = s_inbox_received;
+    s_inbox_received = received_callback;
+    return old;
+}
+
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback) {
+    AppMessageInboxDropped old = s_inbox_dropped;
+    s_inbox_dropped = dropped_callback;
+    return old;
+}
+
+void app_message_deregister_callbacks(void) {
+    s_inbox_received = NULL;
+    s_inbox_dropped = NULL;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator** iterator) {
+    if (!s_message_open) {
+        host_counters.send_failures += 1;
+        return APP_MSG_INVALID_STATE;
+    }
+    if (s_outbox_pending) {
+        host_counters.send_failures += 1;
+        return APP_MSG_BUSY;
+    }
+    s_outbox[0] = 0;
+    s_outbox_iter = (DictionaryIterator){.begin = s_outbox, .end = s_outbox + 1, .limit = s_outbox + s_outbox_size};
+    s_outbox_pending = true;
+    *iterator = &s_outbox_iter;
+    return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_send(void) {
+    if (!s_outbox_pending) {
+        return APP_MSG_INVALID_STATE;
+    }
+    s_outbox_pending = false;
+    if (!s_connected) {
+        host_counters.send_failures += 1;
+        return APP_MSG_NOT_CONNECTED;
+    }
+    host_counters.messages_sent += 1;
+    host_counters.bytes_sent += dict_size(&s_outbox_iter);
+    if (host_outbox_hook) {
+        host_outbox_hook(&s_outbox_iter);
+    }
+    return APP_MSG_OK;
+}
+
+void host_inbox_begin(void) {
+    s_inbox[0] = 0;
+    s_inbox_iter = (DictionaryIterator){.begin = s_inbox, .end = s_inbox + 1, .limit = s_inbox + sizeof s_inbox};
+}
+
+void host_inbox_add_int(uint32_t key, int32_t value) {
+    dict_write_int32(&s_inbox_iter, key, value);
+}
+
+void host_inbox_add_data(uint32_t key, const uint8_t* data, uint16_t length) {
+    dict_write_data(&s_inbox_iter, key, data, length);
+}
+
+void host_inbox_deliver(void) {
+    if (!s_message_open || !s_inbox_received) {
+        host_counters.messages_rejected += 1;
+        return;
+    }
+    host_counters.wakeups += 1;
+    if (dict_size(&s_inbox_iter) > s_inbox_size) {
+        host_counters.messages_dropped += 1;
+        if (s_inbox_dropped) {
+            s_inbox_dropped(APP_MSG_BUFFER_OVERFLOW, NULL);
+        }
+        host_flush();
+        return;
+    }
+    host_counters.messages_received += 1;
+    host_counters.bytes_received += dict_size(&s_inbox_iter);
+    s_inbox_received(&s_inbox_iter, NULL);
+    host_flush();
+}
+
+// --------------------------------------------------------------------------
+// Persistent storage.
+// --------------------------------------------------------------------------
+
+#define PERSIST_DATA_MAX_LENGTH 256
+
+typedef struct {
+    uint32_t key;
+    size_t size;
+    uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} PersistEntry;
+
+static PersistEntry s_persist[16];
+static int s_persist_count;
+
+static PersistEntry* persist_find(uint32_t key) {
+    for (int i = 0; i < s_persist_count; i++) {
+        if (s_persist[i].key == key) {
+            return &s_persist[i];
+        }
+    }
+    return NULL;
+}
+
+int persist_read_data(const uint32_t key, void* buffer, const size_t buffer_size) {
+    PersistEntry* entry = persist_find(key);
+    if (!entry) {
+        return E_DOES_NOT_EXIST;
+    }
+    size_t size = entry->size < buffer_size ? entry->size : buffer_size;
+    memcpy(buffer, entry->data, size);
+    return size;
+}
+
+int persist_write_data(const uint32_t key, const void* data, const size_t size) {
+    if (size > PERSIST_DATA_MAX_LENGTH) {
+        return E_RANGE;
+    }
+    PersistEntry* entry = persist_find(key);
+    if (!entry) {
+        if (s_persist_count == (int)ARRAY_LENGTH(s_persist)) {
+            return E_OUT_OF_STORAGE;
+        }
+        entry = &s_persist[s_persist_count++];
+        entry->key = key;
+    }
+    memcpy(entry->data, data, size);
+    entry->size = size;
+    host_counters.persist_writes += 1;
+    host_counters.persist_bytes += size;
+    return size;
+}
+
+// --------------------------------------------------------------------------
+// Images.
+// --------------------------------------------------------------------------
+
+bool host_write_image(const char* path, const GBitmap* fb) {
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+    int w = fb->bounds.size.w;
+    int h = fb->bounds.size.h;
+#if defined(PBL_BW)
+    fprintf(f, "P4\n%d %d\n", w, h);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x += 8) {
+            uint8_t byte = 0;
+            for (int i = 0; i < 8 && x + i < w; i++) {
+                byte |= !gcolor_equal(bitmap_pixel(fb, x + i, y), GColorWhite) << (7 - i); // PBM: 1 is black.
+            }
+            fputc(byte, f);
+        }
+    }
+#else
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            GColor c = bitmap_pixel(fb, x, y);
+            fputc(c.r * 85, f);
+            fputc(c.g * 85, f);
+            fputc(c.b * 85, f);
+        }
+    }
+#endif
+    return fclose(f) == 0;
+}
+
+int host_compare_image(const char* path, const GBitmap* fb) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return -1;
+    }
+    char magic[3] = {0};
+    int w, h;
+    int differences = -1;
+    if (fscanf(f, "%2s %d %d", magic, &w, &h) != 3 || w != fb->bounds.size.w || h != fb->bounds.size.h) {
+        fclose(f);
+        return -1;
+    }
+#if defined(PBL_BW)
+    if (strcmp(magic, "P4") == 0 && fgetc(f) != EOF) {
+        differences = 0;
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x += 8) {
+                int byte = fgetc(f);
+                for (int i = 0; i < 8 && x + i < w && byte != EOF; i++) {
+                    bool white = !((byte >> (7 - i)) & 1);
+                    differences += white != gcolor_equal(bitmap_pixel(fb, x + i, y), GColorWhite);
+                }
+            }
+        }
+    }
+#else
+    int max_value;
+    if (strcmp(magic, "P6") == 0 && fscanf(f, "%d", &max_value) == 1 && fgetc(f) != EOF) {
+        differences = 0;
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                GColor c = bitmap_pixel(fb, x, y);
+                int r = fgetc(f);
+                int g = fgetc(f);
+                int b = fgetc(f);
+                differences += r != c.r * 85 || g != c.g * 85 || b != c.b * 85;
+            }
+        }
+    }
+#endif
+    fclose(f);
+    return differences;
+}
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Generate the host build's resources.h - the bitmaps of package.json as 8 bit GColor8 pixels.
+
+The SDK converts the images at build time; the host harness gets them from this header instead:
+
+    python3 tools/host/png2c.py package.json resources > tools/host/build/resources.h
+
+Only the PNGs the watchface uses are supported: 8 bits per channel, not interlaced. Resource ids count
+from 1 in package.json order, like the SDK's.
+"""
+import json
+import os
+import struct
+import sys
+import zlib
+
+CHANNELS = {0: 1, 2: 3, 4: 2, 6: 4}  # PNG color type: channels per pixel.
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        raise ValueError('{}: not a PNG'.format(path))
+    pos, idat = 8, b''
+    while pos < len(data):
+        length, kind = struct.unpack('>I4s', data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        if kind == b'IHDR':
+            width, height, depth, color_type, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+        elif kind == b'IDAT':
+            idat += chunk
+        pos += 12 + length
+    if depth != 8 or interlace or color_type not in CHANNELS:
+        raise ValueError('{}: only 8 bit, non-interlaced gray or RGB images are supported'.format(path))
+    channels = CHANNELS[color_type]
+    raw = zlib.decompress(idat)
+    stride = width * channels
+    rows, prev = [], bytearray(stride)
+    for y in range(height):
+        kind = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = line[i - channels] if i >= channels else 0
+            b = prev[i]
+            c = prev[i - channels] if i >= channels else 0
+            line[i] = (line[i] + [0, a, b, (a + b) // 2, paeth(a, b, c)][kind]) & 0xff
+        rows.append(line)
+        prev = line
+    pixels = []
+    for line in rows:
+        for x in range(width):
+            p = line[x * channels:(x + 1) * channels]
+            if channels <= 2:
+                r = g = b = p[0]
+            else:
+                r, g, b = p[0], p[1], p[2]
+            alpha = p[-1] if channels in (2, 4) else 255
+            pixels.append((alpha + 42) // 85 << 6 | (r + 42) // 85 << 4 | (g + 42) // 85 << 2 | (b + 42) // 85)
+    return width, height, pixels
+
+
+def main():
+    package, resources = sys.argv[1], sys.argv[2]
+    with open(package) as f:
+        media = json.load(f)['pebble']['resources']['media']
+    out = ['// Generated by tools/host/png2c.py - do not edit.', '',
+           '#pragma once', '', '#include <pebble.h>', '',
+           'typedef struct {',
+           '    uint32_t id;',
+           '    uint16_t width;',
+           '    uint16_t height;',
+           '    const uint8_t* pixels;',
+           '} HostResource;', '']
+    entries = []
+    for resource_id, item in enumerate(media, 1):
+        if item['type'] != 'bitmap':
+            continue
+        width, height, pixels = read_png(os.path.join(resources, item['file']))
+        name = item['name'].lower()
+        out.append('static const uint8_t RESOURCE_{}[] = {{'.format(name.upper()))
+        for i in range(0, len(pixels), 16):
+            out.append('    ' + ', '.join('0x{:02x}'.format(p) for p in pixels[i:i + 16]) + ',')
+        out.append('};')
+        out.append('')
+        entries.append('    {{{}, {}, {}, RESOURCE_{}}},'.format(resource_id, width, height, name.upper()))
+    out.append('static const HostResource HOST_RESOURCES[] = {')
+    out += entries
+    out.append('};')
+    print('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,278 @@
+// Renders src/c/watchface.c on Linux: compares a few scenarios with the golden images in tools/host/golden,
+// checks that every incremental frame equals a frame drawn from scratch, and times each widget's render
+// proc with its primitive and pixel counts.
+//
+//     render [--update] [--golden DIR] [--out DIR] [--bench N]
+//
+// --update rewrites the golden images, --out writes the images that differ there. Every scenario runs in a
+// process of its own, so each starts from the watchface's initial state.
+
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "host.h"
+
+#define main watchface_main
+#include "watchface.c"
+#undef main
+
+#define IMAGE_EXT PBL_IF_BW_ELSE("pbm", "ppm")
+
+// Monday, 17 October 2016, 10:08:37 UTC.
+#define SCENARIO_TIME 1476698917
+
+static const char* s_golden_dir = "golden";
+static const char* s_out_dir;
+static bool s_update;
+static int s_bench_iterations;
+
+// --------------------------------------------------------------------------
+// The watch's state.
+// --------------------------------------------------------------------------
+
+static uint8_t history_bpm(int minute) {
+    return 62 + (minute * 7) % 23;
+}
+
+static void setup(HealthActivityMask activities) {
+    host_set_time(SCENARIO_TIME);
+    host_set_battery(70, false);
+    host_set_connected(true);
+    host_health_set_sum(HealthMetricRestingKCalories, 1210);
+    host_health_set_sum(HealthMetricActiveKCalories, 240);
+    host_health_set_sum(HealthMetricWalkedDistanceMeters, 4380);
+    host_health_set_sum(HealthMetricSleepSeconds, 7*SECONDS_PER_HOUR + 20*SECONDS_PER_MINUTE);
+    host_health_set_sum(HealthMetricSleepRestfulSeconds, 2*SECONDS_PER_HOUR + 50*SECONDS_PER_MINUTE);
+    host_health_set_bpm(71, false);
+    host_health_fill_history(120, history_bpm);
+    host_health_set_activities(activities);
+}
+
+// Rain starting in a quarter of an hour, and a day of forecast.
+static void deliver_weather() {
+    static const uint8_t precip[] = {PRECIP_ENCODING_VERSION, 0xe0, 0x42, 0x39, 0x5c, 0x36, 0x91, 0x80};
+    uint8_t hourly[1 + 4 + FORECAST_HOURS + FORECAST_HOURS/2] = {HOURLY_ENCODING_VERSION};
+    uint32_t start = SCENARIO_TIME - SCENARIO_TIME % SECONDS_PER_HOUR;
+    for (int i = 0; i < 4; i++) {
+        hourly[1 + i] = start >> (8*i);
+    }
+    for (int i = 0; i < FORECAST_HOURS; i++) {
+        hourly[1 + 4 + i] = (uint8_t)(int8_t)(12 + (i < 6 ? i : 12 - i) - (i > 14 ? 6 : 0));
+        hourly[1 + 4 + FORECAST_HOURS + i/2] |= ((i * 5) % 16) << (i%2 * 4);
+    }
+    host_inbox_begin();
+    host_inbox_add_int(WEATHER_ICON_KEY, 3);
+    host_inbox_add_int(WEATHER_TEMPERATURE_KEY, 12);
+    host_inbox_add_int(WEATHER_TEMPERATUREMAX_KEY, 15);
+    host_inbox_add_int(WEATHER_TEMPERATUREMIN_KEY, -2);
+    host_inbox_add_int(WEATHER_PRECIP_PROB_KEY, 40);
+    host_inbox_add_data(WEATHER_PRECIP_ARRAY_KEY, precip, sizeof precip);
+    host_inbox_add_data(WEATHER_HOURLY_KEY, hourly, sizeof hourly);
+    host_inbox_deliver();
+}
+
+static void start(HealthActivityMask activities) {
+    setup(activities);
+    init();
+    host_flush();
+    deliver_weather();
+}
+
+// --------------------------------------------------------------------------
+// Scenarios.
+// --------------------------------------------------------------------------
+
+static void scenario_full() {
+    start(HealthActivityNone);
+}
+
+// Two taps: the seconds hand, and the precipitation graph's next view.
+static void scenario_forecast() {
+    start(HealthActivityNone);
+    host_run_until(host_now_ms() + 1500);
+    host_tap();
+    host_run_until(host_now_ms() + 2000);
+    host_tap();
+}
+
+static void scenario_minute() {
+    start(HealthActivityNone);
+    host_run_until((SCENARIO_TIME + 23) * 1000LL);
+}
+
+static void scenario_resting() {
+    start(HealthActivitySleep);
+}
+
+typedef struct {
+    const char* name;
+    void (*run)();
+} Scenario;
+
+static const Scenario SCENARIOS[] = {
+    {"full", scenario_full},
+    {"forecast", scenario_forecast},
+    {"minute", scenario_minute},
+    {"resting", scenario_resting},
+};
+
+// --------------------------------------------------------------------------
+// Checks.
+// --------------------------------------------------------------------------
+
+// Draw the current state again from scratch, without the dial cache, and count the pixels that differ
+// from the frame the watchface drew incrementally.
+static int scratch_differences() {
+    GBitmap* fb = host_frame_buffer();
+    GRect bounds = gbitmap_get_bounds(fb);
+    GColor* incremental = malloc(bounds.size.w * bounds.size.h * sizeof(GColor));
+    for (int y = 0; y < bounds.size.h; y++) {
+        for (int x = 0; x < bounds.size.w; x++) {
+            incremental[y * bounds.size.w + x] = host_frame_pixel(x, y);
+        }
+    }
+    gbitmap_destroy(g_dial_bitmap);
+    g_dial_bitmap = NULL;
+    layer_mark_dirty(g_layer);
+    host_flush();
+    int differences = 0;
+    for (int y = 0; y < bounds.size.h; y++) {
+        for (int x = 0; x < bounds.size.w; x++) {
+            differences += !gcolor_equal(incremental[y * bounds.size.w + x], host_frame_pixel(x, y));
+        }
+    }
+    free(incremental);
+    return differences;
+}
+
+static int check(const Scenario* scenario) {
+    scenario->run();
+    HostCounters counters = host_counters;
+    GBitmap* fb = host_frame_buffer();
+    char path[256];
+    snprintf(path, sizeof path, "%s/%s-%s.%s", s_golden_dir, PLATFORM_NAME, scenario->name, IMAGE_EXT);
+    int failed = 0;
+    if (s_update) {
+        if (!host_write_image(path, fb)) {
+            fprintf(stderr, "%s: cannot write\n", path);
+            return 1;
+        }
+    } else {
+        int differences = host_compare_image(path, fb);
+        if (differences != 0) {
+            failed = 1;
+            if (differences < 0) {
+                printf("%s: cannot read\n", path);
+            } else {
+                printf("%s: %d pixels differ\n", path, differences);
+            }
+            if (s_out_dir) {
+                snprintf(path, sizeof path, "%s/%s-%s.%s", s_out_dir, PLATFORM_NAME, scenario->name, IMAGE_EXT);
+                host_write_image(path, fb);
+            }
+        }
+    }
+    int scratch = scratch_differences();
+    if (scratch) {
+        printf("%s %s: %d pixels differ from a frame drawn from scratch\n", PLATFORM_NAME, scenario->name, scratch);
+        failed = 1;
+    }
+    printf("%-8s %-9s %s  frames %3u  primitives %5u  pixels %7u  frame time %6.2f ms\n",
+           PLATFORM_NAME, scenario->name, failed ? "FAIL" : "ok  ", counters.frames, counters.primitives,
+           counters.pixels, counters.frame_us / 1000.0);
+    return failed;
+}
+
+// --------------------------------------------------------------------------
+// Benchmark.
+// --------------------------------------------------------------------------
+
+static const char* const WIDGET_NAMES[WIDGET_COUNT] = {
+    "hands", "seconds", "battery", "connection", "bpm graph", "bpm text", "meters", "sleep", "calories",
+    "temp", "icon", "precipprob", "precipgraph", "message",
+};
+
+// Each render proc over the bare dial, the way a dirty widget is drawn. Times are host times and include
+// the stand-in SDK's own work, e.g. diffing the frame buffer on release to count the pixels - compare them
+// between builds, not with the watch.
+static void bench() {
+    start(HealthActivityNone);
+    host_tap(); // Shows the seconds hand.
+    GContext* ctx = host_graphics_context();
+    graphics_context_set_text_color(ctx, GColorWhite);
+    printf("%-8s %-12s %10s %10s %10s\n", PLATFORM_NAME, "widget", "us/draw", "primitives", "pixels");
+    for (int i = 0; i < WIDGET_COUNT; i++) {
+        Widget* widget = &g_widgets[i];
+        HostCounters before = host_counters;
+        uint64_t elapsed_us = 0;
+        for (int n = 0; n < s_bench_iterations; n++) {
+            dial_cache_restore(ctx, widget->rect);
+            struct timespec t0, t1;
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            widget->render(ctx, widget->rect, widget->data);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            elapsed_us += (t1.tv_sec - t0.tv_sec) * 1000000LL + (t1.tv_nsec - t0.tv_nsec) / 1000;
+        }
+        // Leave out the restores - one primitive and the rect's pixels each.
+        GRect restored = widget->rect;
+        grect_clip(&restored, &GRect(0, 0, g_dial_size.w, g_dial_size.h));
+        uint32_t restore_primitives = !grect_is_empty(&restored);
+        uint32_t restore_pixels = restore_primitives * restored.size.w * restored.size.h;
+        printf("%-8s %-12s %10.2f %10u %10u\n", PLATFORM_NAME, WIDGET_NAMES[i],
+               (double)elapsed_us / s_bench_iterations,
+               (host_counters.primitives - before.primitives) / s_bench_iterations - restore_primitives,
+               (host_counters.pixels - before.pixels) / s_bench_iterations - restore_pixels);
+    }
+}
+
+// --------------------------------------------------------------------------
+// Main.
+// --------------------------------------------------------------------------
+
+static int run_forked(int (*run)(const Scenario*), const Scenario* scenario) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        int status = run(scenario);
+        fflush(stdout);
+        _exit(status);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    return !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+}
+
+static int run_bench(const Scenario* scenario) {
+    bench();
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) {
+            s_update = true;
+        } else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+            s_golden_dir = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            s_out_dir = argv[++i];
+        } else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            s_bench_iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            host_verbose = true;
+        } else {
+            fprintf(stderr, "usage: %s [--update] [--golden DIR] [--out DIR] [--bench N] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+    setenv("TZ", "UTC", 1);
+    tzset();
+    int failed = 0;
+    for (size_t i = 0; i < ARRAY_LENGTH(SCENARIOS); i++) {
+        failed |= run_forked(check, &SCENARIOS[i]);
+    }
+    if (s_bench_iterations > 0) {
+        failed |= run_forked(run_bench, NULL);
+    }
+    return failed;
+}
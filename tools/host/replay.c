@@ -0,0 +1,331 @@
+// Replays an event trace against src/c/watchface.c and reports what the watchface did: wakeups, frames,
+// drawing work per widget, health queries and messages. Two builds fed the same trace can be compared
+// line by line - see `make replay` in the Makefile and gen_trace.py for a synthetic day.
+//
+//     replay [--verbose] TRACE
+//
+// A trace is a text file, one event per line, in time order. `#` starts a comment.
+//
+//     start UNIX_TIME              the clock at time 00:00:00 - must come first
+//     H:MM:SS init                 start the watchface
+//     H:MM:SS tap
+//     H:MM:SS battery PERCENT CHARGING
+//     H:MM:SS connection CONNECTED
+//     H:MM:SS bpm BPM              a heart rate update, 0 - no heart rate (e.g. off-wrist)
+//     H:MM:SS activity none|sleep|restful
+//     H:MM:SS movement             a health movement update
+//     H:MM:SS sum METRIC VALUE     today's sum of steps, active, walked, sleep, restful, resting_kcal or active_kcal
+//     H:MM:SS message KEY=VALUE... a message from the phone; values are integers, or hex bytes after an `x`
+//     H:MM:SS end                  run the clock up to here and stop
+//
+// Events before `init` only set the state the watchface starts with.
+
+#include <stdlib.h>
+
+#include "host.h"
+
+#define main watchface_main
+#include "watchface.c"
+#undef main
+
+// --------------------------------------------------------------------------
+// Widget instrumentation.
+// --------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t draws;
+    uint64_t us;
+    uint32_t primitives;
+    uint32_t pixels;
+} WidgetCounters;
+
+static WidgetCounters s_widget_counters[WIDGET_COUNT];
+static WidgetRender s_widget_renders[WIDGET_COUNT];
+
+static void render_counted(WidgetId id, GContext* ctx, GRect rect, void* data) {
+    HostCounters before = host_counters;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    s_widget_renders[id](ctx, rect, data);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    WidgetCounters* counters = &s_widget_counters[id];
+    counters->draws += 1;
+    counters->us += (t1.tv_sec - t0.tv_sec) * 1000000LL + (t1.tv_nsec - t0.tv_nsec) / 1000;
+    counters->primitives += host_counters.primitives - before.primitives;
+    counters->pixels += host_counters.pixels - before.pixels;
+}
+
+#define RENDER_COUNTED(id) \
+    static void render_counted_##id(GContext* ctx, GRect rect, void* data) { render_counted(id, ctx, rect, data); }
+RENDER_COUNTED(0) RENDER_COUNTED(1) RENDER_COUNTED(2) RENDER_COUNTED(3) RENDER_COUNTED(4)
+RENDER_COUNTED(5) RENDER_COUNTED(6) RENDER_COUNTED(7) RENDER_COUNTED(8) RENDER_COUNTED(9)
+RENDER_COUNTED(10) RENDER_COUNTED(11) RENDER_COUNTED(12) RENDER_COUNTED(13)
+
+static const WidgetRender RENDERS_COUNTED[] = {
+    render_counted_0, render_counted_1, render_counted_2, render_counted_3, render_counted_4,
+    render_counted_5, render_counted_6, render_counted_7, render_counted_8, render_counted_9,
+    render_counted_10, render_counted_11, render_counted_12, render_counted_13,
+};
+_Static_assert(ARRAY_LENGTH(RENDERS_COUNTED) == WIDGET_COUNT, "One counting render proc per widget.");
+
+static const char* const WIDGET_NAMES[WIDGET_COUNT] = {
+    "hands", "seconds", "battery", "connection", "bpm graph", "bpm text", "meters", "sleep", "calories",
+    "temp", "icon", "precipprob", "precipgraph", "message",
+};
+
+static void instrument_widgets() {
+    for (int i = 0; i < WIDGET_COUNT; i++) {
+        s_widget_renders[i] = g_widgets[i].render;
+        g_widgets[i].render = RENDERS_COUNTED[i];
+    }
+}
+
+// --------------------------------------------------------------------------
+// The phone.
+// --------------------------------------------------------------------------
+
+static uint32_t s_sent_by_key[16]; // Messages the watchface sent, by their first key.
+
+static void on_outbox(DictionaryIterator* iter) {
+    Tuple* tuple = dict_read_first(iter);
+    if (tuple && tuple->key < ARRAY_LENGTH(s_sent_by_key)) {
+        s_sent_by_key[tuple->key] += 1;
+    }
+}
+
+// --------------------------------------------------------------------------
+// Trace.
+// --------------------------------------------------------------------------
+
+typedef struct {
+    const char* name;
+    HealthMetric metric;
+} MetricName;
+
+static const MetricName METRIC_NAMES[] = {
+    {"steps", HealthMetricStepCount},
+    {"active", HealthMetricActiveSeconds},
+    {"walked", HealthMetricWalkedDistanceMeters},
+    {"sleep", HealthMetricSleepSeconds},
+    {"restful", HealthMetricSleepRestfulSeconds},
+    {"resting_kcal", HealthMetricRestingKCalories},
+    {"active_kcal", HealthMetricActiveKCalories},
+};
+
+static bool s_started;
+
+// Adds the KEY=VALUE tuples of a message line to the inbox.
+static bool parse_message(char* args) {
+    host_inbox_begin();
+    for (char* field = strtok(args, " \t\n"); field; field = strtok(NULL, " \t\n")) {
+        char* value = strchr(field, '=');
+        if (!value) {
+            return false;
+        }
+        uint32_t key = strtoul(field, NULL, 10);
+        value += 1;
+        if (value[0] == 'x') {
+            uint8_t data[256];
+            size_t length = strlen(value + 1) / 2;
+            if (length > sizeof data) {
+                return false;
+            }
+            for (size_t i = 0; i < length; i++) {
+                unsigned byte;
+                if (sscanf(value + 1 + 2*i, "%2x", &byte) != 1) {
+                    return false;
+                }
+                data[i] = byte;
+            }
+            host_inbox_add_data(key, data, length);
+        } else {
+            host_inbox_add_int(key, strtol(value, NULL, 10));
+        }
+    }
+    return true;
+}
+
+// Delivers one event. Returns false on a line it cannot parse.
+static bool replay_event(const char* event, char* args) {
+    if (strcmp(event, "init") == 0) {
+        init();
+        instrument_widgets();
+        s_started = true;
+        host_flush();
+    } else if (strcmp(event, "tap") == 0) {
+        host_tap();
+    } else if (strcmp(event, "battery") == 0) {
+        int percent, charging;
+        if (sscanf(args, "%d %d", &percent, &charging) != 2) {
+            return false;
+        }
+        host_set_battery(percent, charging);
+    } else if (strcmp(event, "connection") == 0) {
+        host_set_connected(atoi(args));
+    } else if (strcmp(event, "bpm") == 0) {
+        host_health_set_bpm(atoi(args), s_started);
+    } else if (strcmp(event, "activity") == 0) {
+        char name[16];
+        if (sscanf(args, "%15s", name) != 1) {
+            return false;
+        }
+        HealthActivityMask activities = strcmp(name, "sleep") == 0 ? HealthActivitySleep
+                                      : strcmp(name, "restful") == 0 ? HealthActivitySleep | HealthActivityRestfulSleep
+                                      : HealthActivityNone;
+        host_health_set_activities(activities);
+        if (s_started) {
+            host_health_event(HealthEventSleepUpdate);
+        }
+    } else if (strcmp(event, "movement") == 0) {
+        host_health_event(HealthEventMovementUpdate);
+    } else if (strcmp(event, "sum") == 0) {
+        char name[16];
+        int value;
+        if (sscanf(args, "%15s %d", name, &value) != 2) {
+            return false;
+        }
+        size_t i = 0;
+        while (i < ARRAY_LENGTH(METRIC_NAMES) && strcmp(METRIC_NAMES[i].name, name) != 0) {
+            i++;
+        }
+        if (i == ARRAY_LENGTH(METRIC_NAMES)) {
+            return false;
+        }
+        host_health_set_sum(METRIC_NAMES[i].metric, value);
+    } else if (strcmp(event, "message") == 0) {
+        if (!parse_message(args)) {
+            return false;
+        }
+        host_inbox_deliver();
+    } else if (strcmp(event, "end") != 0) {
+        return false;
+    }
+    return true;
+}
+
+static int replay(FILE* f, const char* path, int64_t* duration_ms) {
+    char line[1024];
+    int line_number = 0;
+    int64_t start_ms = -1;
+    while (fgets(line, sizeof line, f)) {
+        line_number += 1;
+        char* comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        char event[16];
+        int consumed = 0;
+        long long start_time;
+        int h, m, s;
+        if (sscanf(line, " %15s", event) != 1) {
+            continue; // Blank.
+        }
+        if (start_ms < 0) {
+            if (sscanf(line, " start %lld", &start_time) != 1) {
+                fprintf(stderr, "%s:%d: the trace must begin with `start`\n", path, line_number);
+                return 1;
+            }
+            host_set_time(start_time);
+            start_ms = start_time * 1000;
+            continue;
+        }
+        consumed = strlen(line);
+        if (sscanf(line, " %d:%d:%d %15s %n", &h, &m, &s, event, &consumed) < 4) {
+            fprintf(stderr, "%s:%d: cannot parse\n", path, line_number);
+            return 1;
+        }
+        int64_t t_ms = start_ms + ((h * 60LL + m) * 60 + s) * 1000;
+        if (t_ms < host_now_ms()) {
+            fprintf(stderr, "%s:%d: out of order\n", path, line_number);
+            return 1;
+        }
+        if (s_started) {
+            host_run_until(t_ms);
+        } else {
+            host_set_time(t_ms / 1000);
+        }
+        if (!replay_event(event, line + consumed)) {
+            fprintf(stderr, "%s:%d: bad `%s` event\n", path, line_number, event);
+            return 1;
+        }
+        if (strcmp(event, "end") == 0) {
+            break;
+        }
+    }
+    if (!s_started) {
+        fprintf(stderr, "%s: no `init` event\n", path);
+        return 1;
+    }
+    *duration_ms = host_now_ms() - start_ms;
+    return 0;
+}
+
+// --------------------------------------------------------------------------
+// Report.
+// --------------------------------------------------------------------------
+
+static void report(const char* path, int64_t duration_ms) {
+    const HostCounters* c = &host_counters;
+    double hours = duration_ms / 3600000.0;
+    printf("%s on %s: %.1f hours\n", path, PLATFORM_NAME, hours);
+    printf("  wakeups           %8u  (%.1f per hour)\n", c->wakeups, c->wakeups / hours);
+    printf("    ticks           %8u\n", c->ticks);
+    printf("    timers          %8u\n", c->timers);
+    printf("    taps            %8u\n", c->taps);
+    printf("    battery         %8u\n", c->battery_events);
+    printf("    connection      %8u\n", c->connection_events);
+    printf("    health          %8u\n", c->health_events);
+    printf("    messages        %8u\n", c->messages_received + c->messages_dropped);
+    printf("  frames            %8u  (%.1f per hour)\n", c->frames, c->frames / hours);
+    printf("  frame time        %8.1f ms on the host\n", c->frame_us / 1000.0);
+    printf("  primitives        %8u\n", c->primitives);
+    printf("  pixels            %8u\n", c->pixels);
+    printf("  health queries    %8u\n", c->health_calls);
+    printf("  received          %8u messages, %u bytes, %u dropped, %u rejected\n",
+           c->messages_received, c->bytes_received, c->messages_dropped, c->messages_rejected);
+    printf("  sent              %8u messages, %u bytes, %u failed\n", c->messages_sent, c->bytes_sent, c->send_failures);
+    printf("    weather request %8u\n", s_sent_by_key[WEATHER_REQUEST_KEY]);
+    printf("    battery         %8u\n", s_sent_by_key[WATCH_BATTERY_KEY]);
+    printf("  persist writes    %8u  (%u bytes)\n", c->persist_writes, c->persist_bytes);
+    printf("  skipped redraws   %8u\n", g_skipped_redraws);
+    printf("  %-16s %9s %10s %11s %10s\n", "widget", "draws", "host ms", "primitives", "pixels");
+    for (int i = 0; i < WIDGET_COUNT; i++) {
+        const WidgetCounters* w = &s_widget_counters[i];
+        printf("    %-14s %9u %10.1f %11u %10u\n", WIDGET_NAMES[i], w->draws, w->us / 1000.0, w->primitives, w->pixels);
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--verbose") == 0) {
+            host_verbose = true;
+        } else if (!path) {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s [--verbose] TRACE\n", argv[0]);
+        return 2;
+    }
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    setenv("TZ", "UTC", 1);
+    tzset();
+    host_outbox_hook = on_outbox;
+    int64_t duration_ms = 0;
+    int status = replay(f, path, &duration_ms);
+    fclose(f);
+    if (status) {
+        return status;
+    }
+    deinit();
+    report(path, duration_ms);
+    return 0;
+}